@@ -13,7 +13,7 @@ use crate::tokio::{
     sync::{Mutex, Notify},
 };
 use esp::ByteReader;
-use globed_shared::{logger::*, should_ignore_error, ServerUserEntry, SyncMutex};
+use globed_shared::{logger::*, should_ignore_error, ServerUserEntry, SyncMutex, PROTOCOL_SEQUENCED_VOICE};
 use handlers::game::MAX_VOICE_PACKET_SIZE;
 use tokio::time::Instant;
 
@@ -36,6 +36,8 @@ pub enum ServerThreadMessage {
     SmallPacket(([u8; INLINE_BUFFER_SIZE], usize)),
     Packet(Vec<u8>),
     BroadcastVoice(Arc<VoiceBroadcastPacket>),
+    /// the same voice frame with and without the sequence number, for clients on protocol 13+ and older ones
+    BroadcastSequencedVoice(Arc<SequencedVoiceBroadcastPacket>, Arc<VoiceBroadcastPacket>),
     BroadcastText(ChatMessageBroadcastPacket),
     BroadcastNotice(ServerNoticePacket),
     BroadcastInvite(RoomInvitePacket),
@@ -66,6 +68,8 @@ pub struct ClientThread {
     pub user_role: SyncMutex<ComputedRole>,
 
     pub fragmentation_limit: AtomicU16,
+    /// sequence number of the next `SequencedLevelDataPacket` sent to this client
+    level_data_sequence: AtomicU16,
 
     pub is_authorized_user: AtomicBool,
 
@@ -129,6 +133,7 @@ impl ClientThread {
             user_role: SyncMutex::new(user_role),
 
             fragmentation_limit: thread.fragmentation_limit,
+            level_data_sequence: AtomicU16::new(0),
 
             is_authorized_user: AtomicBool::new(false),
 
@@ -376,6 +381,13 @@ impl ClientThread {
             ServerThreadMessage::SmallPacket((mut packet, len)) => self.handle_packet(&mut packet[..len]).await?,
             ServerThreadMessage::BroadcastText(text_packet) => self.send_packet_static(&text_packet).await?,
             ServerThreadMessage::BroadcastVoice(voice_packet) => self.send_packet_dynamic(&*voice_packet).await?,
+            ServerThreadMessage::BroadcastSequencedVoice(voice_packet, legacy_packet) => {
+                if self.protocol_version.load(Ordering::Relaxed) >= PROTOCOL_SEQUENCED_VOICE {
+                    self.send_packet_dynamic(&*voice_packet).await?;
+                } else {
+                    self.send_packet_dynamic(&*legacy_packet).await?;
+                }
+            }
             ServerThreadMessage::BroadcastNotice(packet) => {
                 self.send_packet_dynamic(&packet).await?;
                 info!("{} is receiving a notice: {}", self.account_data.lock().name, packet.message);
@@ -422,9 +434,8 @@ impl ClientThread {
         }
 
         // also for optimization, reject the voice/text packet immediately on certain conditions
-        if (header.packet_id == VoicePacket::PACKET_ID || header.packet_id == ChatMessagePacket::PACKET_ID)
-            && !self.is_chat_packet_allowed(header.packet_id == VoicePacket::PACKET_ID, message.len())
-        {
+        let is_voice = header.packet_id == VoicePacket::PACKET_ID || header.packet_id == SequencedVoicePacket::PACKET_ID;
+        if (is_voice || header.packet_id == ChatMessagePacket::PACKET_ID) && !self.is_chat_packet_allowed(is_voice, message.len()) {
             #[cfg(debug_assertions)]
             log::warn!("blocking text/voice packet from {}", self.account_id.load(Ordering::Relaxed));
             return Ok(());
@@ -458,6 +469,7 @@ impl ClientThread {
             PlayerDataPacket::PACKET_ID => self.handle_player_data(&mut data).await,
             VoicePacket::PACKET_ID => self.handle_voice(&mut data).await,
             ChatMessagePacket::PACKET_ID => self.handle_chat_message(&mut data).await,
+            SequencedVoicePacket::PACKET_ID => self.handle_sequenced_voice(&mut data).await,
 
             /* room related */
             CreateRoomPacket::PACKET_ID => self.handle_create_room(&mut data).await,
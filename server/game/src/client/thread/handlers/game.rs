@@ -1,5 +1,7 @@
 use std::sync::{atomic::Ordering, Arc};
 
+use globed_shared::PROTOCOL_SEQUENCED_LEVEL_DATA;
+
 use super::*;
 
 /// max voice packet size in bytes
@@ -87,27 +89,28 @@ impl ClientThread {
             return Ok(());
         }
 
-        let calc_size = size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * written_players;
+        // newer clients get the sequence number of every packet, to drop the ones that arrive late and to measure loss
+        let sequenced = self.protocol_version.load(Ordering::Relaxed) >= PROTOCOL_SEQUENCED_LEVEL_DATA;
+        let header_size = if sequenced { size_of_types!(u16, u32) } else { size_of_types!(u32) };
+
+        let calc_size = header_size + size_of_types!(AssociatedPlayerData) * written_players;
         let fragmentation_limit = self.fragmentation_limit.load(Ordering::Relaxed) as usize;
 
         // if we can fit in one packet, then just send it as-is
         if calc_size <= fragmentation_limit {
-            self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| {
-                self.game_server.state.room_manager.with_any(room_id, |pm| {
-                    buf.write_list_with(written_players, |buf| {
-                        let mut count = 0usize;
-                        pm.manager.for_each_player_on_level(level_id, |player| {
-                            if count < written_players && player.account_id != account_id && (!player.is_invisible || is_mod) {
-                                buf.write_value(&player.to_borrowed_associated_data());
-                                count += 1;
-                            }
-                        });
-
-                        count
-                    });
-                });
-            })
-            .await?;
+            if sequenced {
+                let sequence = self._next_level_data_sequence();
+                self.send_packet_alloca_with::<SequencedLevelDataPacket, _>(calc_size, |buf| {
+                    buf.write_u16(sequence);
+                    self._write_level_players(buf, room_id, level_id, account_id, written_players, is_mod);
+                })
+                .await?;
+            } else {
+                self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| {
+                    self._write_level_players(buf, room_id, level_id, account_id, written_players, is_mod);
+                })
+                .await?;
+            }
         } else {
             // get all players into a vec
             let total_fragments = (calc_size + fragmentation_limit - 1) / fragmentation_limit;
@@ -123,15 +126,25 @@ impl ClientThread {
             });
 
             let players_per_fragment = (players.len() + total_fragments - 1) / total_fragments;
-            let calc_size = size_of_types!(u32) + size_of_types!(AssociatedPlayerData) * players_per_fragment;
+            let calc_size = header_size + size_of_types!(AssociatedPlayerData) * players_per_fragment;
 
             debug!(
                 "sending a fragmented packet (lim: {fragmentation_limit}, per: {players_per_fragment}, frags: {total_fragments}, fragsize: {calc_size})"
             );
 
+            // every fragment is a separate datagram, so each one gets its own sequence number
             for chunk in players.chunks(players_per_fragment) {
-                self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| buf.write_value(chunk))
+                if sequenced {
+                    let sequence = self._next_level_data_sequence();
+                    self.send_packet_alloca_with::<SequencedLevelDataPacket, _>(calc_size, |buf| {
+                        buf.write_u16(sequence);
+                        buf.write_value(chunk);
+                    })
                     .await?;
+                } else {
+                    self.send_packet_alloca_with::<LevelDataPacket, _>(calc_size, |buf| buf.write_value(chunk))
+                        .await?;
+                }
             }
         }
 
@@ -143,6 +156,27 @@ impl ClientThread {
         Ok(())
     });
 
+    /// writes the data of up to `max_players` players on the level, except for `account_id` and players hidden from them
+    fn _write_level_players(&self, buf: &mut FastByteBuffer, room_id: u32, level_id: LevelId, account_id: i32, max_players: usize, is_mod: bool) {
+        self.game_server.state.room_manager.with_any(room_id, |pm| {
+            buf.write_list_with(max_players, |buf| {
+                let mut count = 0usize;
+                pm.manager.for_each_player_on_level(level_id, |player| {
+                    if count < max_players && player.account_id != account_id && (!player.is_invisible || is_mod) {
+                        buf.write_value(&player.to_borrowed_associated_data());
+                        count += 1;
+                    }
+                });
+
+                count
+            });
+        });
+    }
+
+    fn _next_level_data_sequence(&self) -> u16 {
+        self.level_data_sequence.fetch_add(1, Ordering::Relaxed)
+    }
+
     gs_handler!(self, handle_request_profiles, RequestPlayerProfilesPacket, packet, {
         let _ = gs_needauth!(self);
 
@@ -212,6 +246,33 @@ impl ClientThread {
         Ok(())
     });
 
+    gs_handler!(self, handle_sequenced_voice, SequencedVoicePacket, packet, {
+        let account_id = gs_needauth!(self);
+
+        // players on older protocols in the same level get the frame without the sequence number
+        let legacy = Arc::new(VoiceBroadcastPacket {
+            player_id: account_id,
+            data: packet.data.clone(),
+        });
+
+        let vpkt = Arc::new(SequencedVoiceBroadcastPacket {
+            player_id: account_id,
+            sequence: packet.sequence,
+            data: packet.data,
+        });
+
+        self.game_server
+            .broadcast_sequenced_voice_packet(
+                &vpkt,
+                &legacy,
+                self.level_id.load(Ordering::Relaxed),
+                self.room_id.load(Ordering::Relaxed),
+            )
+            .await;
+
+        Ok(())
+    });
+
     gs_handler!(self, handle_chat_message, ChatMessagePacket, packet, {
         let account_id = gs_needauth!(self);
 
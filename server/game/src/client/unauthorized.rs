@@ -303,8 +303,12 @@ impl UnauthorizedThread {
 
             socket
                 .send_packet_dynamic(&ProtocolMismatchPacket {
-                    // send minimum required version
-                    protocol: MIN_SUPPORTED_PROTOCOL,
+                    // a newer client can fall back to our newest version, an older one needs to update to at least our oldest one
+                    protocol: if packet.protocol > MAX_SUPPORTED_PROTOCOL {
+                        MAX_SUPPORTED_PROTOCOL
+                    } else {
+                        MIN_SUPPORTED_PROTOCOL
+                    },
                     min_client_version: MIN_CLIENT_VERSION,
                 })
                 .await?;
@@ -475,6 +479,12 @@ impl UnauthorizedThread {
         let all_roles = self.game_server.state.role_manager.get_all_roles();
         let special_user_data = self.account_data.lock().special_user_data.clone();
 
+        // the version used for this session, clients older than protocol 13 reject any version they don't know
+        let server_protocol = match self.protocol_version.load(Ordering::Relaxed) {
+            0xffff => MAX_SUPPORTED_PROTOCOL,
+            x => x,
+        };
+
         let socket = self.get_socket();
 
         socket
@@ -483,7 +493,7 @@ impl UnauthorizedThread {
                 all_roles,
                 secret_key: self.secret_key,
                 special_user_data,
-                server_protocol: MAX_SUPPORTED_PROTOCOL,
+                server_protocol,
             })
             .await
     }
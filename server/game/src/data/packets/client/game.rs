@@ -35,3 +35,10 @@ pub struct VoicePacket {
 pub struct ChatMessagePacket {
     pub message: InlineString<MAX_MESSAGE_SIZE>,
 }
+
+#[derive(Packet, Decodable)]
+#[packet(id = 12012, encrypted = true)]
+pub struct SequencedVoicePacket {
+    pub sequence: u16,
+    pub data: FastEncodedAudioFrame,
+}
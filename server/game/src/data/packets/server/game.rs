@@ -18,6 +18,13 @@ pub struct LevelPlayerMetadataPacket {
     pub players: Vec<AssociatedPlayerMetadata>,
 }
 
+#[derive(Packet, Encodable)]
+#[packet(id = 22003, tcp = false)]
+pub struct SequencedLevelDataPacket {
+    pub sequence: u16,
+    pub players: Vec<AssociatedPlayerData>,
+}
+
 #[derive(Packet, Encodable, DynamicSize)]
 #[packet(id = 22010, encrypted = true, tcp = false)]
 pub struct VoiceBroadcastPacket {
@@ -31,3 +38,11 @@ pub struct ChatMessageBroadcastPacket {
     pub player_id: i32,
     pub message: InlineString<MAX_MESSAGE_SIZE>,
 }
+
+#[derive(Packet, Encodable, DynamicSize)]
+#[packet(id = 22012, encrypted = true, tcp = false)]
+pub struct SequencedVoiceBroadcastPacket {
+    pub player_id: i32,
+    pub sequence: u16,
+    pub data: FastEncodedAudioFrame,
+}
@@ -38,6 +38,10 @@ use crate::{
 };
 
 const INLINE_BUFFER_SIZE: usize = 164;
+
+/// Packet ID of a UDP datagram carrying multiple packets (protocol 13 and newer).
+/// After the packet header, every packet is prefixed with its length as a u16.
+const BATCH_PACKET_ID: u16 = 0;
 const MAX_UDP_PACKET_SIZE: usize = 65536;
 const LARGE_BUFFER_SIZE: usize = 2usize.pow(19); // 2^19, 0.5mb
 
@@ -404,18 +408,47 @@ impl GameServer {
             SocketAddr::V6(_) => bail!("rejecting request from ipv6 host"),
         };
 
+        let data = &buf[..len];
+
+        let header = ByteReader::from_bytes(data).read_packet_header().map_err(|e| anyhow!("{e}"))?;
+        if header.packet_id != BATCH_PACKET_ID {
+            return self.handle_udp_packet(data, peer).await;
+        }
+
+        // a batch, every packet in it is handled as if it came in a datagram of its own
+        let mut reader = ByteReader::from_bytes(data);
+        reader.set_rpos(PacketHeader::SIZE);
+
+        while reader.get_rpos() < data.len() {
+            let length = reader.read_length().map_err(|e| anyhow!("{e}"))?;
+            let start = reader.get_rpos();
+
+            if length < PacketHeader::SIZE || length > data.len() - start {
+                bail!("batched packet has an invalid length ({length})");
+            }
+
+            self.handle_udp_packet(&data[start..start + length], peer).await?;
+            reader.set_rpos(start + length);
+        }
+
+        Ok(())
+    }
+
+    async fn handle_udp_packet(&self, data: &[u8], peer: SocketAddrV4) -> anyhow::Result<()> {
         // if it's a ping packet, we can handle it here. otherwise we send it to the appropriate thread.
-        if !self.try_udp_handle(&buf[..len], peer).await? {
+        if !self.try_udp_handle(data, peer).await? {
             let thread = { self.clients.lock().get(&peer).cloned() };
             if let Some(thread) = thread {
+                let len = data.len();
+
                 thread
                     .push_new_message(if len <= INLINE_BUFFER_SIZE {
                         let mut inline_buf = [0u8; INLINE_BUFFER_SIZE];
-                        inline_buf[..len].clone_from_slice(&buf[..len]);
+                        inline_buf[..len].clone_from_slice(data);
 
                         ServerThreadMessage::SmallPacket((inline_buf, len))
                     } else {
-                        ServerThreadMessage::Packet(buf[..len].to_vec())
+                        ServerThreadMessage::Packet(data.to_vec())
                     })
                     .await;
             }
@@ -442,6 +475,22 @@ impl GameServer {
             .await;
     }
 
+    pub async fn broadcast_sequenced_voice_packet(
+        &self,
+        vpkt: &Arc<SequencedVoiceBroadcastPacket>,
+        legacy: &Arc<VoiceBroadcastPacket>,
+        level_id: LevelId,
+        room_id: u32,
+    ) {
+        self.broadcast_user_message(
+            &ServerThreadMessage::BroadcastSequencedVoice(vpkt.clone(), legacy.clone()),
+            vpkt.player_id,
+            level_id,
+            room_id,
+        )
+        .await;
+    }
+
     pub async fn broadcast_chat_packet(&self, tpkt: &ChatMessageBroadcastPacket, level_id: LevelId, room_id: u32) {
         self.broadcast_user_message(&ServerThreadMessage::BroadcastText(tpkt.clone()), tpkt.player_id, level_id, room_id)
             .await;
@@ -38,9 +38,13 @@ pub mod logger;
 pub mod token_issuer;
 pub mod webhook;
 
-pub const SUPPORTED_PROTOCOLS: &[u16] = &[12];
+pub const SUPPORTED_PROTOCOLS: &[u16] = &[12, 13];
 pub const MAX_SUPPORTED_PROTOCOL: u16 = *SUPPORTED_PROTOCOLS.last().unwrap();
 pub const MIN_SUPPORTED_PROTOCOL: u16 = *SUPPORTED_PROTOCOLS.first().unwrap();
+// first protocol where voice is sent with sequence numbers (SequencedVoicePacket and SequencedVoiceBroadcastPacket)
+pub const PROTOCOL_SEQUENCED_VOICE: u16 = 13;
+// first protocol where level data is sent with sequence numbers (SequencedLevelDataPacket)
+pub const PROTOCOL_SEQUENCED_LEVEL_DATA: u16 = 13;
 // used for communicating to the user the minimum required mod version for this protocol
 pub const MIN_CLIENT_VERSION: &str = "v1.6.1";
 pub const SERVER_MAGIC: &[u8] = b"\xdd\xeeglobed\xda\xee";
@@ -3,8 +3,11 @@
 #include "decoder.hpp"
 #include "encoder.hpp"
 #include "frame.hpp"
+#include "jitter_buffer.hpp"
 #include "manager.hpp"
-#include "sample_queue.hpp"
+#include "ring_buffer.hpp"
 #include "stream.hpp"
+#include "voice_activity.hpp"
+#include "voice_mixer.hpp"
 #include "voice_playback_manager.hpp"
 #include "voice_record_manager.hpp"
@@ -77,6 +77,39 @@ Result<DecodedOpusData> AudioDecoder::decode(const EncodedOpusData& data) {
     return this->decode(data.ptr, data.length);
 }
 
+Result<DecodedOpusData> AudioDecoder::decodeLost() {
+    DecodedOpusData out;
+
+    out.length = frameSize * channels;
+    out.ptr = new float[out.length];
+
+    // passing no data makes opus conceal the missing frame
+    _res = opus_decode_float(decoder, nullptr, 0, out.ptr, frameSize, 0);
+
+    if (_res < 0) {
+        delete[] out.ptr;
+        GLOBED_UNWRAP(this->errcheck("opus_decode_float (plc)"));
+    }
+
+    return Ok(out);
+}
+
+Result<DecodedOpusData> AudioDecoder::decodeFec(const EncodedOpusData& next) {
+    DecodedOpusData out;
+
+    out.length = frameSize * channels;
+    out.ptr = new float[out.length];
+
+    _res = opus_decode_float(decoder, next.ptr, next.length, out.ptr, frameSize, 1);
+
+    if (_res < 0) {
+        delete[] out.ptr;
+        GLOBED_UNWRAP(this->errcheck("opus_decode_float (fec)"));
+    }
+
+    return Ok(out);
+}
+
 Result<> AudioDecoder::setSampleRate(int sampleRate) {
     this->sampleRate = sampleRate;
     return this->remakeDecoder();
@@ -37,6 +37,15 @@ public:
     // After you no longer need the decoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioDecoder::freeData(data)`
     [[nodiscard]] Result<DecodedOpusData> decode(const EncodedOpusData& data);
 
+    // Produces a frame of audio in place of one that never arrived, using packet loss concealment (PLC).
+    // After you no longer need the decoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioDecoder::freeData(data)`
+    [[nodiscard]] Result<DecodedOpusData> decodeLost();
+
+    // Recovers the frame that came before `next` from the forward error correction (FEC) data in `next`, or conceals it if there is none.
+    // `next` must still be decoded normally afterwards.
+    // After you no longer need the decoded data, you must call `data.freeData()`, or (preferrably, for explicitness) `AudioDecoder::freeData(data)`
+    [[nodiscard]] Result<DecodedOpusData> decodeFec(const EncodedOpusData& next);
+
     static void freeData(DecodedOpusData& data) {
         data.freeData();
     }
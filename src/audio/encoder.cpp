@@ -23,6 +23,10 @@ template<> void ByteBuffer::customEncode(const EncodedOpusData& data) {
     this->rawWriteBytes(data.ptr, data.length);
 }
 
+template<> size_t ByteBuffer::customEncodedSize(const EncodedOpusData& data) {
+    return sizeof(uint32_t) + data.length;
+}
+
 template<> ByteBuffer::DecodeResult<EncodedOpusData> ByteBuffer::customDecode() {
     EncodedOpusData out;
 
@@ -133,6 +137,19 @@ Result<> AudioEncoder::setVariableBitrate(bool variablebr) {
     return this->errcheck("AudioEncoder::setVariableBitrate");
 }
 
+Result<> AudioEncoder::setInbandFec(bool enabled, int expectedLossPercent) {
+    _res = opus_encoder_ctl(encoder, OPUS_SET_INBAND_FEC(enabled ? 1 : 0));
+    GLOBED_UNWRAP(this->errcheck("AudioEncoder::setInbandFec"));
+
+    _res = opus_encoder_ctl(encoder, OPUS_SET_PACKET_LOSS_PERC(expectedLossPercent));
+    return this->errcheck("AudioEncoder::setInbandFec");
+}
+
+Result<> AudioEncoder::setDtx(bool enabled) {
+    _res = opus_encoder_ctl(encoder, OPUS_SET_DTX(enabled ? 1 : 0));
+    return this->errcheck("AudioEncoder::setDtx");
+}
+
 Result<> AudioEncoder::remakeEncoder() {
     // if we are reinitializing, free the previous encoder
     if (encoder) {
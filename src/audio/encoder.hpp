@@ -46,6 +46,13 @@ public:
     // sets the amount of channels that will be used and recreates the encoder
     Result<> setChannels(int channels);
 
+    // enables or disables in-band forward error correction, which lets the decoder recover a lost frame from the frame after it.
+    // costs extra bitrate, depending on the expected packet loss (0-100)
+    Result<> setInbandFec(bool enabled, int expectedLossPercent);
+
+    // enables or disables discontinuous transmission. when enabled, silent frames are encoded into 2 bytes or less, and don't need to be sent
+    Result<> setDtx(bool enabled);
+
 private:
     // EXPERIMENTAL ZONE
     //
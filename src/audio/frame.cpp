@@ -66,6 +66,19 @@ template<> void ByteBuffer::customEncode(const EncodedAudioFrame& frame) {
     }
 }
 
+template<> size_t ByteBuffer::customEncodedSize(const EncodedAudioFrame& frame) {
+    size_t total = 0;
+
+    for (auto& frame : frame.frames) {
+        total += sizeof(bool) + encodedSize(frame);
+    }
+
+    // nullopts for the missing frames
+    total += (EncodedAudioFrame::VOICE_MAX_FRAMES_IN_AUDIO_FRAME - frame.frames.size()) * sizeof(bool);
+
+    return total;
+}
+
 template<> ByteBuffer::DecodeResult<EncodedAudioFrame> ByteBuffer::customDecode() {
     EncodedAudioFrame eframe;
 
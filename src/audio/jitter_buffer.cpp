@@ -0,0 +1,240 @@
+#include "jitter_buffer.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+using util::time::micros;
+using util::time::time_point;
+
+// the target delay is this many times the interarrival jitter
+static constexpr double JITTER_FACTOR = 3.0;
+
+// how much of the late frame delay is kept with each played frame, so that the target delay goes back down after a jitter spike (halves in ~8 seconds)
+static constexpr double LATE_DECAY = 0.995;
+
+// how many frames are concealed when playback runs dry, before going silent
+static constexpr size_t MAX_STALL_CONCEAL = 2;
+
+// if a packet is this far behind what was already played, the sender is assumed to have started over
+static constexpr int64_t RESTART_DISTANCE = 1024;
+
+VoiceJitterBuffer::VoiceJitterBuffer(micros frameDuration) : frameDuration(frameDuration) {}
+
+void VoiceJitterBuffer::push(uint16_t sequence, std::shared_ptr<const EncodedAudioFrame> packet, time_point arrival) {
+    const auto& opusFrames = packet->getFrames();
+    if (opusFrames.empty()) return;
+
+    int64_t first = this->unwrap(sequence);
+
+    if (everPlayed && first + RESTART_DISTANCE < nextSeq) {
+        auto stats = _stats;
+        this->reset();
+        _stats = stats;
+
+        first = this->unwrap(sequence);
+    }
+
+    if (started) {
+        // how much the time between this packet and the previous one differs from the time between their frames.
+        // anything longer than the idle timeout is a pause in speech rather than jitter
+        int64_t d = util::time::asMicros(arrival - lastArrival) - (first - lastArrivalSeq) * frameDuration.count();
+        if (std::abs(d) < IDLE_TIMEOUT.count()) {
+            jitterUs += (static_cast<double>(std::abs(d)) - jitterUs) / 16.0;
+        }
+    }
+
+    int64_t last = first + static_cast<int64_t>(opusFrames.size()) - 1;
+    newestSeq = started ? std::max(newestSeq, last) : last;
+    started = true;
+
+    lastArrival = arrival;
+    lastArrivalSeq = first;
+
+    for (size_t i = 0; i < opusFrames.size(); i++) {
+        int64_t seq = first + static_cast<int64_t>(i);
+
+        if (everPlayed && seq < nextSeq) {
+            _stats.late++;
+            continue;
+        }
+
+        auto [_, inserted] = frames.try_emplace(seq, Entry {
+            .frame = Frame {
+                .packet = packet,
+                .data = &opusFrames[i],
+            },
+            .ready = arrival + frameDuration * static_cast<int64_t>(i),
+        });
+
+        if (!inserted) {
+            _stats.duplicates++;
+        }
+    }
+
+    while (frames.size() > MAX_FRAMES) {
+        frames.erase(frames.begin());
+        _stats.overflowed++;
+    }
+}
+
+std::optional<VoiceJitterBuffer::Output> VoiceJitterBuffer::pop(time_point now) {
+    if (!isPlaying) {
+        if (frames.empty()) return std::nullopt;
+
+        auto it = frames.begin();
+        if (now < it->second.ready + this->targetDelay()) return std::nullopt;
+
+        // start of a talk spurt
+        if (everPlayed && it->first > nextSeq) {
+            _stats.lost += it->first - nextSeq;
+        }
+
+        isPlaying = true;
+        stalled = false;
+        anchorSeq = it->first;
+        anchorTime = now;
+
+        return this->take(it, now);
+    }
+
+    if (frames.empty()) {
+        if (!stalled) {
+            stalled = true;
+            stallStart = now;
+            stallConcealed = 0;
+        } else if (now - stallStart >= IDLE_TIMEOUT) {
+            // nothing came in for a while, so the speaker must have stopped talking
+            isPlaying = false;
+            stalled = false;
+            return std::nullopt;
+        }
+
+        // fill the start of the gap, which sounds less abrupt than silence. this doesn't skip the frame,
+        // if it arrives later it is still played (and everything after it is delayed by the concealment)
+        if (stallConcealed < MAX_STALL_CONCEAL) {
+            stallConcealed++;
+            _stats.concealed++;
+
+            return Output {
+                .kind = Output::Kind::Conceal,
+                .sequence = static_cast<uint16_t>(nextSeq),
+            };
+        }
+
+        return std::nullopt;
+    }
+
+    auto it = frames.begin();
+
+    if (stalled) {
+        stalled = false;
+
+        // if the frame arrived after it should have been played, the delay is too small
+        auto lateness = util::time::as<micros>(it->second.ready - this->scheduledTime(it->first));
+        if (lateness.count() > 0) {
+            _stats.stalls++;
+            _stats.stallTime += lateness;
+            lateUs = std::max(lateUs, static_cast<double>((this->targetDelay() + lateness).count()));
+        }
+
+        // whatever was missing before this frame had its turn while we were waiting
+        _stats.lost += it->first - nextSeq;
+        anchorSeq = it->first;
+        anchorTime = now;
+
+        return this->take(it, now);
+    }
+
+    if (it->first - nextSeq > static_cast<int64_t>(MAX_FRAMES)) {
+        // too much is missing to be worth concealing
+        _stats.lost += it->first - nextSeq;
+        anchorSeq = it->first;
+        anchorTime = now;
+
+        return this->take(it, now);
+    }
+
+    if (it->first != nextSeq) {
+        // a later frame is here already, so this one is most likely lost
+        Output out {
+            .kind = Output::Kind::Conceal,
+            .sequence = static_cast<uint16_t>(nextSeq),
+        };
+
+        if (it->first == nextSeq + 1) {
+            out.frame = it->second.frame;
+            _stats.concealedFec++;
+        }
+
+        _stats.concealed++;
+        nextSeq++;
+
+        return out;
+    }
+
+    // if this frame has waited a lot longer than needed, drop it and play the next one, to bring the delay back down
+    if (now - it->second.ready > this->targetDelay() + frameDuration) {
+        auto next = std::next(it);
+
+        if (next != frames.end() && next->first == nextSeq + 1) {
+            frames.erase(it);
+            it = next;
+            anchorTime -= frameDuration;
+            _stats.shrunk++;
+        }
+    }
+
+    return this->take(it, now);
+}
+
+VoiceJitterBuffer::Output VoiceJitterBuffer::take(std::map<int64_t, Entry>::iterator it, time_point now) {
+    Output out {
+        .kind = Output::Kind::Play,
+        .sequence = static_cast<uint16_t>(it->first),
+        .frame = std::move(it->second.frame),
+    };
+
+    if (now > it->second.ready) {
+        _stats.addedDelay += util::time::as<micros>(now - it->second.ready);
+    }
+
+    _stats.played++;
+    lateUs *= LATE_DECAY;
+
+    nextSeq = it->first + 1;
+    everPlayed = true;
+    frames.erase(it);
+
+    return out;
+}
+
+micros VoiceJitterBuffer::targetDelay() const {
+    double us = std::max(jitterUs * JITTER_FACTOR, lateUs);
+    us = std::clamp(us, static_cast<double>(MIN_DELAY.count()), static_cast<double>(MAX_DELAY.count()));
+
+    return micros(static_cast<int64_t>(us));
+}
+
+bool VoiceJitterBuffer::playing() const {
+    return isPlaying;
+}
+
+const VoiceJitterBuffer::Stats& VoiceJitterBuffer::stats() const {
+    return _stats;
+}
+
+void VoiceJitterBuffer::reset() {
+    *this = VoiceJitterBuffer(frameDuration);
+}
+
+int64_t VoiceJitterBuffer::unwrap(uint16_t sequence) const {
+    if (!started) return sequence;
+
+    auto offset = static_cast<int16_t>(static_cast<uint16_t>(sequence - static_cast<uint16_t>(newestSeq)));
+    return newestSeq + offset;
+}
+
+time_point VoiceJitterBuffer::scheduledTime(int64_t seq) const {
+    return anchorTime + frameDuration * (seq - anchorSeq);
+}
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,123 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <map>
+#include <memory>
+#include <optional>
+
+#include "frame.hpp"
+#include <util/time.hpp>
+
+// Holds back the opus frames of a single speaker for a short while, to play them in order and at a steady pace,
+// even though packets arrive with jitter, out of order or not at all.
+//
+// Frames are numbered by the sender (16-bit, wrapping). Playback of a talk spurt starts `targetDelay()` after its first frame arrived.
+// The target delay follows the jitter between packet arrivals, and grows whenever a frame arrived too late to be played in time.
+// A missing frame is concealed once a later frame has arrived. If the buffer runs dry in the middle of a spurt,
+// the first moments are concealed, and then playback waits.
+//
+// Not thread safe.
+class VoiceJitterBuffer {
+public:
+    // the target delay never goes beyond these
+    static constexpr util::time::micros MIN_DELAY{20'000};
+    static constexpr util::time::micros MAX_DELAY{1'000'000};
+
+    // if there is nothing to play for this long, the talk spurt is considered over
+    static constexpr util::time::micros IDLE_TIMEOUT{300'000};
+
+    // at most this many frames are held, older ones get dropped
+    static constexpr size_t MAX_FRAMES = 64;
+
+    struct Frame {
+        // keeps `data` alive
+        std::shared_ptr<const EncodedAudioFrame> packet;
+        const EncodedOpusData* data = nullptr;
+    };
+
+    struct Output {
+        enum class Kind {
+            Play,    // decode `frame`
+            Conceal, // the frame is missing. `frame` is the one right after it if it's there (for FEC), otherwise empty (for PLC)
+        };
+
+        Kind kind;
+        // of the frame that should be played, even if it's missing
+        uint16_t sequence;
+        Frame frame;
+    };
+
+    struct Stats {
+        uint64_t played = 0;
+        uint64_t concealed = 0;    // including the ones while playback ran dry
+        uint64_t concealedFec = 0; // out of `concealed`
+        uint64_t lost = 0;         // skipped without concealing, because playback had to wait for them anyway
+        uint64_t late = 0;         // arrived after their turn, dropped
+        uint64_t duplicates = 0;
+        uint64_t overflowed = 0;   // dropped because the buffer was full
+        uint64_t shrunk = 0;       // dropped to bring the delay back down to the target
+        uint64_t stalls = 0;       // times playback ran dry because a frame was late
+        util::time::micros stallTime{0};
+        // total time that played frames spent waiting in the buffer
+        util::time::micros addedDelay{0};
+    };
+
+    explicit VoiceJitterBuffer(util::time::micros frameDuration);
+
+    // Adds the frames of a packet, `sequence` being the number of its first frame
+    void push(uint16_t sequence, std::shared_ptr<const EncodedAudioFrame> packet, util::time::time_point arrival);
+
+    // Returns what should be played next, or nullopt if nothing should be played right now
+    std::optional<Output> pop(util::time::time_point now);
+
+    util::time::micros targetDelay() const;
+
+    // Whether a talk spurt is being played right now
+    bool playing() const;
+
+    const Stats& stats() const;
+
+    void reset();
+
+private:
+    struct Entry {
+        Frame frame;
+        // when the frame could have been played at the earliest
+        util::time::time_point ready;
+    };
+
+    util::time::micros frameDuration;
+    std::map<int64_t, Entry> frames;
+
+    // newest sequence number seen so far, unwrapped
+    int64_t newestSeq = 0;
+    // sequence number of the next frame to be played, meaningful once something has been played
+    int64_t nextSeq = 0;
+    bool started = false;
+    bool everPlayed = false;
+
+    bool isPlaying = false;
+    bool stalled = false;
+    util::time::time_point stallStart;
+    size_t stallConcealed = 0;
+
+    // frame `anchorSeq` is (or was) played at `anchorTime`, and every frame after it one frame duration later
+    int64_t anchorSeq = 0;
+    util::time::time_point anchorTime;
+
+    // interarrival jitter estimate as in RFC 3550, and the most a frame was late recently (decays over time)
+    double jitterUs = 0.0;
+    double lateUs = 0.0;
+    util::time::time_point lastArrival;
+    int64_t lastArrivalSeq = 0;
+
+    Stats _stats;
+
+    int64_t unwrap(uint16_t sequence) const;
+    util::time::time_point scheduledTime(int64_t seq) const;
+    Output take(std::map<int64_t, Entry>::iterator it, util::time::time_point now);
+};
+
+#endif // GLOBED_VOICE_SUPPORT
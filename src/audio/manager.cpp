@@ -36,6 +36,17 @@ using permission::Permission;
 GlobedAudioManager::GlobedAudioManager()
     : encoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS) {
 
+    // frames of a packet get lost together, but FEC still lets the receiver recover the last one from the next packet
+    auto fecResult = encoder.setInbandFec(true, 10);
+    if (!fecResult) {
+        log::warn("failed to enable opus FEC: {}", fecResult.unwrapErr());
+    }
+
+    auto dtxResult = encoder.setDtx(true);
+    if (!dtxResult) {
+        log::warn("failed to enable opus DTX: {}", dtxResult.unwrapErr());
+    }
+
     audioThreadHandle.setLoopFunction(&GlobedAudioManager::audioThreadFunc);
 
     // initializing COM is not necessary as FMOD will do it on its own, but FMOD docs recommend doing it anyway.
@@ -220,6 +231,15 @@ void GlobedAudioManager::setRecordBufferCapacity(size_t frames) {
     recordFrame.setCapacity(frames);
 }
 
+void GlobedAudioManager::setSilenceSuppression(bool enabled, float hangover) {
+    recordSuppressSilence = enabled;
+    recordHangoverFrames = static_cast<size_t>(std::round(std::max(hangover, 0.f) / VOICE_CHUNK_RECORD_TIME));
+}
+
+size_t GlobedAudioManager::takeSuppressedFrames() {
+    return std::exchange(recordSuppressedFrames, 0);
+}
+
 Result<> GlobedAudioManager::startRecordingInternal(bool passive) {
     if (!permission::getPermissionStatus(Permission::RecordAudio)) {
         return Err("Recording failed, please grant microphone permission in Globed settings");
@@ -260,6 +280,8 @@ Result<> GlobedAudioManager::startRecordingInternal(bool passive) {
     recordQueuedStop = false;
     recordQueuedHalt = false;
     recordLastPosition = 0;
+    recordVad.reset();
+    recordSuppressedFrames = 0;
     recordActive = true;
     recordingPassive = passive;
 
@@ -542,18 +564,36 @@ Result<> GlobedAudioManager::audioThreadWork() {
 
     if (recordingRaw) {
         // raw recording, call the raw callback with the pcm data directly.
-        float* pcm = recordQueue.data();
-        size_t samples = recordQueue.size();
-        this->recordInvokeRawCallback(pcm, samples);
-        recordQueue.clear();
+        float pcmbuf[VOICE_TARGET_FRAMESIZE];
+        while (size_t samples = recordQueue.copyTo(pcmbuf, VOICE_TARGET_FRAMESIZE)) {
+            this->recordInvokeRawCallback(pcmbuf, samples);
+        }
     } else {
         // encoded recording, encode the data and push to the frame.
         if (recordQueue.size() >= VOICE_TARGET_FRAMESIZE) {
             float pcmbuf[VOICE_TARGET_FRAMESIZE];
             recordQueue.copyTo(pcmbuf, VOICE_TARGET_FRAMESIZE);
 
-            GLOBED_UNWRAP_INTO(encoder.encode(pcmbuf), auto opusFrame);
-            GLOBED_UNWRAP(recordFrame.pushOpusFrame(opusFrame));
+            recordVad.setHangover(recordHangoverFrames);
+            bool send = !recordSuppressSilence || recordVad.process(pcmbuf, VOICE_TARGET_FRAMESIZE);
+
+            if (send) {
+                GLOBED_UNWRAP_INTO(encoder.encode(pcmbuf), auto opusFrame);
+
+                // with DTX, this is what opus gives back for silence
+                if (opusFrame.length <= 2) {
+                    AudioEncoder::freeData(opusFrame);
+                    send = false;
+                } else {
+                    GLOBED_UNWRAP(recordFrame.pushOpusFrame(opusFrame));
+                }
+            }
+
+            if (!send) {
+                // send out what came before the silence right away, instead of holding it until the next words
+                this->recordInvokeCallback();
+                recordSuppressedFrames++;
+            }
         }
 
         // if we are at capacity, or we just stopped passive recording, call the callback
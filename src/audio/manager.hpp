@@ -11,7 +11,8 @@
 #include <asp/thread.hpp>
 
 #include "frame.hpp"
-#include "sample_queue.hpp"
+#include "ring_buffer.hpp"
+#include "voice_activity.hpp"
 
 struct AudioRecordingDevice {
     int id = -1;
@@ -74,6 +75,14 @@ public:
     // set the amount of record frames in a buffer (used by the lowerAudioLatency setting)
     void setRecordBufferCapacity(size_t frames);
 
+    // enable or disable skipping recorded frames that contain no speech. `hangover` is how long to keep sending after speech stops, in seconds.
+    // frames that opus itself considers silent (with DTX) are skipped either way
+    void setSilenceSuppression(bool enabled, float hangover);
+
+    // returns how many frames were skipped since the last call, because they were silent.
+    // only meant to be called from the record callback
+    size_t takeSuppressedFrames();
+
     // start recording the voice and call the callback once a full frame is ready.
     // if `stopRecording()` is called at any point, the callback will be called with the remaining data.
     // in that case it may have less than the full 10 frames.
@@ -138,9 +147,14 @@ private:
     size_t recordChunkSize = 0;
     std::function<void(const EncodedAudioFrame&)> recordCallback;
     std::function<void(const float*, size_t)> recordRawCallback;
-    AudioSampleQueue recordQueue;
+    AudioRingBuffer recordQueue{VOICE_TARGET_SAMPLERATE * 2};
     unsigned int recordLastPosition = 0;
     EncodedAudioFrame recordFrame;
+    asp::AtomicBool recordSuppressSilence = false;
+    std::atomic<size_t> recordHangoverFrames = 0;
+    // only used by the audio thread while recording
+    VoiceActivityDetector recordVad;
+    size_t recordSuppressedFrames = 0;
 
     Result<> startRecordingInternal(bool passive = false);
     void recordContinueStream();
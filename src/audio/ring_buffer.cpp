@@ -0,0 +1,78 @@
+#include "ring_buffer.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <algorithm>
+#include <bit>
+#include <cstring> // std::memcpy
+
+AudioRingBuffer::AudioRingBuffer(size_t capacity) {
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+
+    buf = std::make_unique<float[]>(capacity);
+    mask = capacity - 1;
+}
+
+size_t AudioRingBuffer::writeData(const float* pcm, size_t length) {
+    size_t write = writePos.load(std::memory_order::relaxed);
+    size_t read = readPos.load(std::memory_order::acquire);
+
+    size_t count = std::min(length, this->capacity() - (write - read));
+    size_t start = write & mask;
+    size_t firstPart = std::min(count, this->capacity() - start);
+
+    std::memcpy(buf.get() + start, pcm, firstPart * sizeof(float));
+    std::memcpy(buf.get(), pcm + firstPart, (count - firstPart) * sizeof(float));
+
+    writePos.store(write + count, std::memory_order::release);
+
+    return count;
+}
+
+size_t AudioRingBuffer::writeData(const DecodedOpusData& data) {
+    return this->writeData(data.ptr, data.length);
+}
+
+size_t AudioRingBuffer::copyTo(float* dest, size_t samples) {
+    size_t read = readPos.load(std::memory_order::relaxed);
+    size_t write = writePos.load(std::memory_order::acquire);
+
+    size_t count = std::min(samples, write - read);
+    size_t start = read & mask;
+    size_t firstPart = std::min(count, this->capacity() - start);
+
+    std::memcpy(dest, buf.get() + start, firstPart * sizeof(float));
+    std::memcpy(dest + firstPart, buf.get(), (count - firstPart) * sizeof(float));
+
+    readPos.store(read + count, std::memory_order::release);
+
+    return count;
+}
+
+size_t AudioRingBuffer::skip(size_t samples) {
+    size_t read = readPos.load(std::memory_order::relaxed);
+    size_t write = writePos.load(std::memory_order::acquire);
+
+    size_t count = std::min(samples, write - read);
+    readPos.store(read + count, std::memory_order::release);
+
+    return count;
+}
+
+void AudioRingBuffer::clear() {
+    readPos.store(writePos.load(std::memory_order::acquire), std::memory_order::release);
+}
+
+size_t AudioRingBuffer::size() const {
+    size_t read = readPos.load(std::memory_order::acquire);
+    size_t write = writePos.load(std::memory_order::acquire);
+
+    // loaded in this order, the write position can only be newer, so this never underflows
+    return write - read;
+}
+
+size_t AudioRingBuffer::capacity() const {
+    return mask + 1;
+}
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,55 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <atomic>
+#include <memory>
+
+#include "decoder.hpp"
+
+// Fixed-capacity ring buffer of PCM samples, for handing audio from one thread to another (e.g. to the FMOD mixer thread).
+// One thread may write while another one reads at the same time. Neither side ever blocks or allocates,
+// the writer drops samples that don't fit and the reader gets fewer samples than it asked for.
+class AudioRingBuffer {
+public:
+    // The capacity is rounded up to a power of two
+    explicit AudioRingBuffer(size_t capacity);
+
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    /* Writer side */
+
+    // Returns how many samples were written, less than `length` if the buffer got full
+    size_t writeData(const float* pcm, size_t length);
+    size_t writeData(const DecodedOpusData& data);
+
+    /* Reader side */
+
+    // Moves up to `samples` of the oldest samples into `dest`, returns how many were copied
+    size_t copyTo(float* dest, size_t samples);
+
+    // Drops up to `samples` of the oldest samples, returns how many were dropped
+    size_t skip(size_t samples);
+
+    // Drops everything that was written so far
+    void clear();
+
+    /* Either side */
+
+    // Amount of samples ready to be read. From the writer side, this may be more than what is actually left.
+    size_t size() const;
+    size_t capacity() const;
+
+private:
+    std::unique_ptr<float[]> buf;
+    size_t mask;
+
+    // both only ever increase, so that a full buffer can be told apart from an empty one.
+    // on separate cache lines, as each is written by a different thread
+    alignas(64) std::atomic<size_t> writePos = 0;
+    alignas(64) std::atomic<size_t> readPos = 0;
+};
+
+#endif // GLOBED_VOICE_SUPPORT
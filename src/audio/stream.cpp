@@ -5,9 +5,22 @@
 #include "manager.hpp"
 #include <util/misc.hpp>
 
-AudioStream::AudioStream(AudioDecoder&& decoder)
-    : decoder(std::move(decoder)),
-      estimator(std::move(VolumeEstimator(VOICE_TARGET_SAMPLERATE))) {
+// how much decoded audio can be queued up before new frames start getting dropped
+static constexpr size_t STREAM_BUFFER_SAMPLES = VOICE_TARGET_SAMPLERATE * 2;
+
+// the jitter buffer is asked for more frames whenever less than this is queued for playback.
+// FMOD reads half of it at once, so the other half is what the decode thread has to respond to a refill request in time
+static constexpr size_t PLAYBACK_LOW_WATER = VOICE_TARGET_FRAMESIZE;
+
+static constexpr util::time::micros OPUS_FRAME_DURATION{VOICE_TARGET_FRAMESIZE * 1'000'000 / VOICE_TARGET_SAMPLERATE};
+
+AudioStream::AudioStream(AudioDecoder&& decoder, bool mixed)
+    : queue(STREAM_BUFFER_SAMPLES),
+      jitterBuffer(OPUS_FRAME_DURATION),
+      decoder(std::move(decoder)),
+      estimator(VOICE_TARGET_SAMPLERATE) {
+    if (mixed) return;
+
     FMOD_CREATESOUNDEXINFO exinfo = {};
 
     exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
@@ -16,6 +29,8 @@ AudioStream::AudioStream(AudioDecoder&& decoder)
     exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
     exinfo.userdata = this;
     exinfo.length = sizeof(float) * exinfo.numchannels * exinfo.defaultfrequency * (VOICE_CHUNK_RECORD_TIME * 1);
+    // FMOD reads 400ms at a time by default, which would drain the queue in one go and add latency on top of the jitter buffer
+    exinfo.decodebuffersize = VOICE_TARGET_FRAMESIZE / 2;
 
     exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data, unsigned int len) -> FMOD_RESULT {
         FMOD::Sound* sound = reinterpret_cast<FMOD::Sound*>(sound_);
@@ -27,22 +42,7 @@ AudioStream::AudioStream(AudioDecoder&& decoder)
             return FMOD_OK;
         }
 
-        // write data..
-
-        size_t neededSamples = len / sizeof(float);
-        size_t copied = stream->queue.lock()->copyTo(reinterpret_cast<float*>(data), neededSamples);
-        stream->estimator.lock()->feedData(reinterpret_cast<const float*>(data), copied);
-
-        if (copied != neededSamples) {
-            stream->starving = true;
-            // fill the rest with the void to not repeat stuff
-            for (size_t i = copied; i < neededSamples; i++) {
-                ((float*)data)[i] = 0.0f;
-            }
-        } else {
-            stream->starving = false;
-            stream->lastPlaybackTime = util::time::now();
-        }
+        stream->readData(reinterpret_cast<float*>(data), len / sizeof(float));
 
         return FMOD_OK;
     };
@@ -71,65 +71,77 @@ AudioStream::~AudioStream() {
     }
 }
 
-AudioStream::AudioStream(AudioStream&& other) noexcept {
-    sound = other.sound;
-    channel = other.channel;
-    other.sound = nullptr;
-    other.channel = nullptr;
+void AudioStream::start() {
+    if (this->channel || !this->sound) {
+        return;
+    }
 
-    *queue.lock() = std::move(*other.queue.lock());
-    decoder = std::move(other.decoder);
-    *estimator.lock() = std::move(*other.estimator.lock());
+    this->channel = GlobedAudioManager::get().playSound(sound);
 }
 
-AudioStream& AudioStream::operator=(AudioStream&& other) noexcept {
-    if (this != &other) {
-        if (this->sound) {
-            this->sound->release();
-        }
+void AudioStream::pushFrame(std::optional<uint16_t> sequence, std::shared_ptr<const EncodedAudioFrame> frame, util::time::time_point arrival) {
+    uint16_t first = sequence.value_or(nextUnsequenced);
+    nextUnsequenced = first + frame->size();
 
-        if (this->channel) {
-            this->channel->stop();
-        }
+    jitterBuffer.push(first, std::move(frame), arrival);
+}
 
-        this->sound = other.sound;
-        this->channel = other.channel;
+Result<> AudioStream::updatePlayback(util::time::time_point now) {
+    refillRequested = false;
 
-        other.sound = nullptr;
-        other.channel = nullptr;
+    while (queue.size() < PLAYBACK_LOW_WATER) {
+        auto output = jitterBuffer.pop(now);
+        if (!output) break;
 
-        *queue.lock() = std::move(*other.queue.lock());
-        decoder = std::move(other.decoder);
-        *estimator.lock() = std::move(*other.estimator.lock());
-    }
+        const auto* opusFrame = output->frame.data;
 
-    return *this;
-}
+        DecodedOpusData decodedFrame;
+        if (output->kind == VoiceJitterBuffer::Output::Kind::Play) {
+            GLOBED_UNWRAP_INTO(decoder.decode(*opusFrame), decodedFrame);
+        } else if (opusFrame) {
+            GLOBED_UNWRAP_INTO(decoder.decodeFec(*opusFrame), decodedFrame);
+        } else {
+            GLOBED_UNWRAP_INTO(decoder.decodeLost(), decodedFrame);
+        }
 
-void AudioStream::start() {
-    if (this->channel) {
-        return;
+        queue.writeData(decodedFrame);
+
+        AudioDecoder::freeData(decodedFrame);
     }
 
-    this->channel = GlobedAudioManager::get().playSound(sound);
+    return Ok();
 }
 
-Result<> AudioStream::writeData(const EncodedAudioFrame& frame) {
-    const auto& frames = frame.getFrames();
-    for (const auto& opusFrame : frames) {
-        auto decodedFrame_ = decoder.decode(opusFrame);
-        GLOBED_UNWRAP_INTO(decodedFrame_, auto decodedFrame);
+void AudioStream::setRefillCallback(std::function<void()> callback) {
+    refillCallback = std::move(callback);
+}
 
-        queue.lock()->writeData(decodedFrame);
+void AudioStream::writeData(const float* pcm, size_t samples) {
+    queue.writeData(pcm, samples);
+}
 
-        AudioDecoder::freeData(decodedFrame);
+size_t AudioStream::readData(float* out, size_t samples) {
+    // never blocks, the mixer thread must not wait on the main thread
+    size_t copied = queue.copyTo(out, samples);
+    estimator.feedData(out, copied);
+
+    // playback is paced by the reads here rather than a timer on the decode thread, so it keeps up with how fast FMOD actually plays
+    if (refillCallback && queue.size() < PLAYBACK_LOW_WATER && !refillRequested.exchange(true)) {
+        refillCallback();
     }
 
-    return Ok();
-}
+    if (copied != samples) {
+        starving = true;
+        // fill the rest with the void to not repeat stuff
+        for (size_t i = copied; i < samples; i++) {
+            out[i] = 0.0f;
+        }
+    } else {
+        starving = false;
+        lastPlaybackTime = util::time::now();
+    }
 
-void AudioStream::writeData(const float* pcm, size_t samples) {
-    queue.lock()->writeData(pcm, samples);
+    return copied;
 }
 
 void AudioStream::setVolume(float volume) {
@@ -145,11 +157,11 @@ float AudioStream::getVolume() {
 }
 
 void AudioStream::updateEstimator(float dt) {
-    estimator.lock()->update(dt);
+    estimator.update(dt);
 }
 
 float AudioStream::getLoudness() {
-    return estimator.lock()->getVolume() * this->volume;
+    return estimator.getVolume() * this->volume;
 }
 
 util::time::time_point AudioStream::getLastPlaybackTime() {
@@ -4,32 +4,42 @@
 #ifdef GLOBED_VOICE_SUPPORT
 
 #include "frame.hpp"
-#include "sample_queue.hpp"
+#include "ring_buffer.hpp"
 #include "decoder.hpp"
+#include "jitter_buffer.hpp"
 #include "volume_estimator.hpp"
 
+#include <atomic>
+#include <functional>
+
 #include <asp/sync.hpp>
 #include <util/time.hpp>
 
 class GLOBED_DLL AudioStream {
 public:
-    AudioStream(AudioDecoder&& decoder);
+    // if `mixed` is true, the stream has no FMOD sound of its own and has to be added to a `VoiceMixer` to be heard
+    AudioStream(AudioDecoder&& decoder, bool mixed = false);
     ~AudioStream();
 
-    // prevent copying since we manually free the sound
+    // prevent copying and moving, since we manually free the sound and the FMOD callback holds a pointer to this stream
     AudioStream(const AudioStream&) = delete;
-    AudioStream operator=(const AudioStream& other) = delete;
-
-    // allow moving
-    AudioStream(AudioStream&& other) noexcept;
-    AudioStream& operator=(AudioStream&& other) noexcept;
+    AudioStream& operator=(const AudioStream&) = delete;
 
-    // start playing this stream
+    // start playing this stream, does nothing for mixed streams
     void start();
-    // write an audio frame to this stream. returns error if opus decoding failed
-    Result<> writeData(const EncodedAudioFrame& frame);
-    // write raw audio data to this stream
+    // add an audio frame to the jitter buffer of this stream, it gets decoded later by `updatePlayback`.
+    // frames without a sequence number are assumed to follow the previous frame
+    void pushFrame(std::optional<uint16_t> sequence, std::shared_ptr<const EncodedAudioFrame> frame, util::time::time_point arrival);
+    // decode frames from the jitter buffer until there is enough audio queued for playback. returns error if opus decoding failed
+    Result<> updatePlayback(util::time::time_point now);
+    // set the function that `readData` calls once the queued audio runs low, which should make sure `updatePlayback` gets called soon.
+    // it runs on the FMOD mixer thread, so it must not block. must be set before the stream starts playing
+    void setRefillCallback(std::function<void()> callback);
+    // write raw audio data to this stream, bypassing the jitter buffer. must not be mixed with `pushFrame`
     void writeData(const float* pcm, size_t samples);
+    // read decoded audio for playback, filling the rest of `out` with silence if there isn't enough. returns how many samples were actually read.
+    // only called from the FMOD mixer thread
+    size_t readData(float* out, size_t samples);
 
     // set the volume of the stream (0.0f - 1.0f, beyond 1.0f amplifies)
     void setVolume(float volume);
@@ -47,10 +57,19 @@ public:
 private:
     FMOD::Sound* sound = nullptr;
     FMOD::Channel* channel = nullptr;
-    asp::Mutex<AudioSampleQueue> queue;
+    // written by the thread that calls `writeData`, read by the FMOD mixer thread
+    AudioRingBuffer queue;
+    // pushed to and decoded by the same thread, which is the only writer of `queue`
+    VoiceJitterBuffer jitterBuffer;
+    uint16_t nextUnsequenced = 0;
+    std::function<void()> refillCallback;
+    // set by the FMOD mixer thread when it calls `refillCallback`, so it doesn't ask again until `updatePlayback` has run
+    std::atomic<bool> refillRequested = false;
     AudioDecoder decoder;
-    asp::Mutex<VolumeEstimator> estimator;
-    float volume = 0.f;
+    // fed by the FMOD mixer thread
+    VolumeEstimator estimator;
+    // read by the FMOD mixer thread when mixed
+    std::atomic<float> volume = 0.f;
     util::time::time_point lastPlaybackTime;
 };
 
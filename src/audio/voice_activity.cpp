@@ -0,0 +1,61 @@
+#include "voice_activity.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <util/misc.hpp>
+
+// speech has to be this many times more energetic than the noise floor (~6 dB)
+static constexpr float SPEECH_RATIO = 4.f;
+// unvoiced speech only has to be this many times more energetic (~3 dB), if it also crosses zero this often
+static constexpr float UNVOICED_RATIO = 2.f;
+static constexpr float UNVOICED_ZERO_CROSSING_RATE = 0.3f;
+
+// the noise floor is never assumed to be lower than this (-70 dBFS), otherwise any sound after digital silence counts as speech.
+// it's also the floor until enough frames were seen, so that talking right away doesn't get mistaken for noise
+static constexpr float MIN_NOISE_FLOOR = 1e-7f;
+
+bool VoiceActivityDetector::process(const float* pcm, size_t samples) {
+    auto activity = util::misc::calculatePcmActivity(pcm, samples);
+    float floor = this->noiseFloor();
+
+    recentEnergy[recentPos] = activity.energy;
+    recentPos = (recentPos + 1) % NOISE_WINDOW;
+    recentCount = std::min(recentCount + 1, NOISE_WINDOW);
+
+    bool speech = activity.energy > floor * SPEECH_RATIO
+        || (activity.energy > floor * UNVOICED_RATIO && activity.zeroCrossingRate > UNVOICED_ZERO_CROSSING_RATE);
+
+    if (speech) {
+        hangoverLeft = hangover;
+        return true;
+    }
+
+    if (hangoverLeft > 0) {
+        hangoverLeft--;
+        return true;
+    }
+
+    return false;
+}
+
+void VoiceActivityDetector::setHangover(size_t frames) {
+    hangover = frames;
+    hangoverLeft = std::min(hangoverLeft, frames);
+}
+
+void VoiceActivityDetector::reset() {
+    recentCount = 0;
+    recentPos = 0;
+    hangoverLeft = 0;
+}
+
+float VoiceActivityDetector::noiseFloor() const {
+    if (recentCount < NOISE_WINDOW) {
+        return MIN_NOISE_FLOOR;
+    }
+
+    float floor = *std::min_element(recentEnergy.begin(), recentEnergy.end());
+    return std::max(floor, MIN_NOISE_FLOOR);
+}
+
+#endif // GLOBED_VOICE_SUPPORT
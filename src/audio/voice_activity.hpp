@@ -0,0 +1,42 @@
+#pragma once
+#include <defs/platform.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include <array>
+#include <cstddef>
+
+// Decides whether a recorded frame contains speech, from its energy and zero-crossing rate.
+//
+// The energy is compared against a noise floor, which is the energy of the quietest frame in the last ~2 seconds,
+// so a constant background noise (fans, mic hiss) doesn't count as speech, while the pauses between words keep the floor down.
+// Quieter frames with a high zero-crossing rate are still accepted, since those are usually unvoiced sounds like "s" or "f".
+// After speech stops, frames keep being accepted for `hangover` frames, so that the ends of words are not cut off.
+//
+// Not thread safe.
+class GLOBED_DLL VoiceActivityDetector {
+public:
+    // how many recent frames the noise floor is taken from
+    static constexpr size_t NOISE_WINDOW = 32;
+
+    // Returns whether the frame should be sent
+    bool process(const float* pcm, size_t samples);
+
+    // Set how many frames after the last one with speech are still accepted
+    void setHangover(size_t frames);
+
+    // Forget the noise floor and end the hangover
+    void reset();
+
+private:
+    std::array<float, NOISE_WINDOW> recentEnergy{};
+    size_t recentCount = 0;
+    size_t recentPos = 0;
+
+    size_t hangover = 0;
+    size_t hangoverLeft = 0;
+
+    float noiseFloor() const;
+};
+
+#endif // GLOBED_VOICE_SUPPORT
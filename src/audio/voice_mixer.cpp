@@ -0,0 +1,119 @@
+#include "voice_mixer.hpp"
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include "manager.hpp"
+#include <util/misc.hpp>
+
+// same as `AudioStream`, the streams are decoded ahead only by about a frame
+static constexpr size_t MIXER_READ_SAMPLES = VOICE_TARGET_FRAMESIZE / 2;
+
+VoiceMixer::VoiceMixer() {
+    scratch.resize(MIXER_READ_SAMPLES);
+
+    FMOD_CREATESOUNDEXINFO exinfo = {};
+
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.numchannels = 1;
+    exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+    exinfo.defaultfrequency = VOICE_TARGET_SAMPLERATE;
+    exinfo.userdata = this;
+    exinfo.length = sizeof(float) * exinfo.numchannels * exinfo.defaultfrequency * (VOICE_CHUNK_RECORD_TIME * 1);
+    exinfo.decodebuffersize = MIXER_READ_SAMPLES;
+
+    exinfo.pcmreadcallback = [](FMOD_SOUND* sound_, void* data, unsigned int len) -> FMOD_RESULT {
+        FMOD::Sound* sound = reinterpret_cast<FMOD::Sound*>(sound_);
+        VoiceMixer* mixer = nullptr;
+        sound->getUserData((void**)&mixer);
+
+        if (!mixer || !data) {
+            log::warn("voice mixer is nullptr in cb, ignoring");
+            return FMOD_OK;
+        }
+
+        mixer->mix(reinterpret_cast<float*>(data), len / sizeof(float));
+
+        return FMOD_OK;
+    };
+
+    FMOD_RESULT res;
+    auto system = GlobedAudioManager::get().getSystem();
+    res = system->createStream(nullptr, FMOD_OPENUSER | FMOD_2D | FMOD_LOOP_NORMAL, &exinfo, &sound);
+
+    GLOBED_REQUIRE(res == FMOD_OK, GlobedAudioManager::formatFmodError(res, "System::createStream"))
+}
+
+VoiceMixer::~VoiceMixer() {
+    if (sound) {
+        sound->setUserData(nullptr);
+    }
+
+    if (channel) {
+        channel->stop();
+    }
+
+    if (sound) {
+        sound->release();
+    }
+}
+
+void VoiceMixer::start() {
+    if (this->channel) {
+        return;
+    }
+
+    this->channel = GlobedAudioManager::get().playSound(sound);
+}
+
+void VoiceMixer::addStream(int playerId, std::shared_ptr<AudioStream> stream) {
+    auto s = sources.lock();
+
+    for (auto& [id, existing] : *s) {
+        if (id == playerId) {
+            existing = std::move(stream);
+            return;
+        }
+    }
+
+    s->emplace_back(playerId, std::move(stream));
+}
+
+void VoiceMixer::removeStream(int playerId) {
+    std::shared_ptr<AudioStream> removed;
+
+    auto s = sources.lock();
+
+    auto it = std::find_if(s->begin(), s->end(), [&](const auto& source) { return source.first == playerId; });
+    if (it == s->end()) return;
+
+    // destroyed after unlocking, so the mixer thread doesn't wait for it
+    removed = std::move(it->second);
+    s->erase(it);
+}
+
+bool VoiceMixer::empty() {
+    return sources.lock()->empty();
+}
+
+void VoiceMixer::mix(float* out, size_t samples) {
+    std::fill_n(out, samples, 0.f);
+
+    // only happens if FMOD asks for more than the decode buffer size
+    if (scratch.size() < samples) {
+        scratch.resize(samples);
+    }
+
+    auto s = sources.lock();
+
+    for (const auto& [_, stream] : *s) {
+        // streams are read even when muted, otherwise their audio would pile up
+        size_t copied = stream->readData(scratch.data(), samples);
+        float volume = stream->getVolume();
+
+        if (copied != 0 && volume != 0.f) {
+            util::misc::mixPcm(out, scratch.data(), copied, volume);
+        }
+    }
+}
+
+#endif // GLOBED_VOICE_SUPPORT
@@ -0,0 +1,43 @@
+#pragma once
+#include <defs/geode.hpp>
+
+#ifdef GLOBED_VOICE_SUPPORT
+
+#include "stream.hpp"
+
+#include <asp/sync.hpp>
+
+// Plays the voices of many players through a single FMOD sound, instead of one sound and one channel per player.
+// The FMOD mixer thread reads every added stream and sums them up, each scaled by its own volume.
+class GLOBED_DLL VoiceMixer {
+public:
+    VoiceMixer();
+    ~VoiceMixer();
+
+    // the FMOD callback holds a pointer to the mixer
+    VoiceMixer(const VoiceMixer&) = delete;
+    VoiceMixer& operator=(const VoiceMixer&) = delete;
+
+    // start playing the mixed sound
+    void start();
+
+    // add a stream created with `mixed` set to true. replaces the previous stream of the player, if any
+    void addStream(int playerId, std::shared_ptr<AudioStream> stream);
+    void removeStream(int playerId);
+    // whether there are no streams left to mix
+    bool empty();
+
+private:
+    using Sources = std::vector<std::pair<int, std::shared_ptr<AudioStream>>>;
+
+    FMOD::Sound* sound = nullptr;
+    FMOD::Channel* channel = nullptr;
+    // only locked for a moment by the main thread, to add or remove streams, so the mixer thread barely ever waits on it
+    asp::Mutex<Sources> sources;
+    // only used by the FMOD mixer thread
+    std::vector<float> scratch;
+
+    void mix(float* out, size_t samples);
+};
+
+#endif // GLOBED_VOICE_SUPPORT
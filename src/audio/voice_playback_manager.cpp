@@ -4,111 +4,289 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-Result<> VoicePlaybackManager::playFrameStreamed(int playerId, const EncodedAudioFrame& frame) {
-    // if the stream doesn't exist yet, create it
-    if (!streams.contains(playerId)) {
-        this->prepareStream(playerId);
+#include <managers/error_queues.hpp>
+#include <managers/settings.hpp>
+
+// the decode thread is woken up by new frames and by streams running low on audio, otherwise it only checks this often whether it should stop
+static constexpr auto STOP_CHECK_INTERVAL = util::time::millis(100);
+
+VoicePlaybackManager::VoicePlaybackManager() {
+    decodeThread.setStartFunction([] { geode::utils::thread::setName("Voice Decode Thread"); });
+    decodeThread.setLoopFunction(&VoicePlaybackManager::decodeThreadFunc);
+    decodeThread.start(this);
+}
+
+VoicePlaybackManager::~VoicePlaybackManager() {
+    decodeThread.stopAndWait();
+
+    // streams call into `decodeQueue` from the FMOD mixer thread, so they have to be gone before it is destroyed
+    mixer.reset();
+
+    auto s = streams.lock();
+    s->active.clear();
+    s->removed.clear();
+}
+
+void VoicePlaybackManager::queueFrameStreamed(int playerId, std::shared_ptr<const EncodedAudioFrame> frame, std::optional<uint16_t> sequence) {
+    decodeQueue.push(DecodeTask {
+        .playerId = playerId,
+        .sequence = sequence,
+        .frame = std::move(frame),
+        .arrival = util::time::now(),
+    });
+}
+
+void VoicePlaybackManager::decodeThreadFunc(decltype(decodeThread)::StopToken&) {
+    if (auto task = decodeQueue.popTimeout(STOP_CHECK_INTERVAL)) {
+        this->handleDecodeTask(std::move(task.value()));
+
+        while (auto task = decodeQueue.tryPop()) {
+            this->handleDecodeTask(std::move(task.value()));
+        }
+    }
+
+    // copied out so that the main thread is not blocked while decoding
+    {
+        auto s = streams.lock();
+        for (const auto& [_, stream] : s->active) {
+            playbackStreams.push_back(stream);
+        }
+    }
+
+    auto now = util::time::now();
+    for (const auto& stream : playbackStreams) {
+        this->updatePlayback(*stream, now);
     }
 
-    auto& stream = streams.at(playerId);
-    return stream->writeData(frame);
+    // don't keep removed streams alive until the next iteration
+    playbackStreams.clear();
+
+    // this thread no longer uses the removed streams, so the main thread can destroy them (which releases their FMOD sounds)
+    std::vector<std::shared_ptr<AudioStream>> removed;
+    {
+        auto s = streams.lock();
+        removed.swap(s->removed);
+    }
+
+    if (!removed.empty()) {
+        Loader::get()->queueInMainThread([removed = std::move(removed)] {});
+    }
 }
 
-void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, size_t samples) {
-    if (!streams.contains(playerId)) {
-        this->prepareStream(playerId);
+void VoicePlaybackManager::handleDecodeTask(DecodeTask&& task) {
+    auto s = streams.lock();
+
+    auto it = s->active.find(task.playerId);
+    if (it == s->active.end()) {
+        // the main thread hasn't created the stream yet, or the player should not be heard.
+        // hold back the frame in case it's the former, so the first words of a player don't get lost
+        if (task.frame) {
+            s->heldBack.insert_or_assign(task.playerId, std::move(task));
+        }
+
+        return;
+    }
+
+    auto stream = it->second;
+
+    std::optional<DecodeTask> heldBack;
+    if (auto hit = s->heldBack.find(task.playerId); hit != s->heldBack.end()) {
+        heldBack = std::move(hit->second);
+        s->heldBack.erase(hit);
+    }
+
+    s.unlock();
+
+    if (heldBack) {
+        stream->pushFrame(heldBack->sequence, std::move(heldBack->frame), heldBack->arrival);
+    }
+
+    if (task.frame) {
+        stream->pushFrame(task.sequence, std::move(task.frame), task.arrival);
     }
+}
 
-    auto& stream = streams.at(playerId);
-    stream->writeData(pcm, samples);
+void VoicePlaybackManager::updatePlayback(AudioStream& stream, util::time::time_point now) {
+    try {
+        auto result = stream.updatePlayback(now);
+
+        if (result.isErr()) {
+            ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + result.unwrapErr());
+        }
+    } catch (const std::exception& e) {
+        ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + e.what());
+    }
+}
+
+std::shared_ptr<AudioStream> VoicePlaybackManager::getStream(int playerId) {
+    auto s = streams.lock();
+
+    auto it = s->active.find(playerId);
+    if (it == s->active.end()) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, size_t samples) {
+    this->prepareStream(playerId);
+
+    this->getStream(playerId)->writeData(pcm, samples);
 }
 
 void VoicePlaybackManager::stopAllStreams() {
-    streams.clear();
+    auto s = streams.lock();
+    for (auto& [_, stream] : s->active) {
+        s->removed.push_back(std::move(stream));
+    }
+
+    s->active.clear();
+    s->heldBack.clear();
+
+    // the mixer sound keeps playing (and calling back into the mixer) for as long as it exists, so it's only kept while there are voices to mix
+    mixer.reset();
 }
 
 void VoicePlaybackManager::prepareStream(int playerId) {
-    if (streams.contains(playerId)) return;
+    auto s = streams.lock();
+    if (s->active.contains(playerId)) return;
 
     AudioDecoder decoder(VOICE_TARGET_SAMPLERATE, VOICE_TARGET_FRAMESIZE, VOICE_CHANNELS);
 
-    auto stream = std::make_unique<AudioStream>(std::move(decoder));
-    stream->start();
-    streams.emplace(playerId, std::move(stream));
+    bool mixed = GlobedSettings::get().communication.voiceMixer;
+    auto stream = std::make_shared<AudioStream>(std::move(decoder), mixed);
+
+    // a task without a frame makes the decode thread top up the streams, so FMOD pulls the decoding along as it plays
+    stream->setRefillCallback([this, playerId] {
+        decodeQueue.push(DecodeTask {
+            .playerId = playerId,
+            .frame = nullptr,
+        });
+    });
+
+    if (mixed) {
+        if (!mixer) {
+            mixer = std::make_unique<VoiceMixer>();
+            mixer->start();
+        }
+
+        mixer->addStream(playerId, stream);
+    } else {
+        stream->start();
+    }
+
+    s->active.emplace(playerId, std::move(stream));
+
+    bool hasHeldBack = s->heldBack.contains(playerId);
+    s.unlock();
+
+    // let the decode thread play the frame that arrived before the stream existed
+    if (hasHeldBack) {
+        decodeQueue.push(DecodeTask {
+            .playerId = playerId,
+            .frame = nullptr,
+        });
+    }
 }
 
 void VoicePlaybackManager::removeStream(int playerId) {
-    streams.erase(playerId);
+    auto s = streams.lock();
+    if (auto it = s->active.find(playerId); it != s->active.end()) {
+        s->removed.push_back(std::move(it->second));
+        s->active.erase(it);
+    }
+
+    s->heldBack.erase(playerId);
+
+    if (mixer) {
+        mixer->removeStream(playerId);
+
+        if (mixer->empty()) {
+            mixer.reset();
+        }
+    }
 }
 
 bool VoicePlaybackManager::isSpeaking(int playerId) {
-    if (!streams.contains(playerId)) {
+    auto stream = this->getStream(playerId);
+    if (!stream) {
         return false;
     }
 
-    return !streams.at(playerId)->starving;
+    return !stream->starving;
 }
 
 void VoicePlaybackManager::setVolume(int playerId, float volume) {
-    if (!streams.contains(playerId)) {
+    auto stream = this->getStream(playerId);
+    if (!stream) {
         return;
     }
 
-    streams.at(playerId)->setVolume(volume);
+    stream->setVolume(volume);
 }
 
 float VoicePlaybackManager::getVolume(int playerId) {
-    if (!streams.contains(playerId)) {
+    auto stream = this->getStream(playerId);
+    if (!stream) {
         return 0.f;
     }
 
-    return streams.at(playerId)->getVolume();
+    return stream->getVolume();
 }
 
 void VoicePlaybackManager::muteEveryone() {
-    for (const auto& [playerId, stream] : streams) {
+    auto s = streams.lock();
+    for (const auto& [playerId, stream] : s->active) {
         stream->setVolume(0.f);
     }
 }
 
 void VoicePlaybackManager::setVolumeAll(float volume) {
-    for (const auto& [playerId, stream] : streams) {
+    auto s = streams.lock();
+    for (const auto& [playerId, stream] : s->active) {
         stream->setVolume(volume);
     }
 }
 
 void VoicePlaybackManager::updateEstimator(int playerId, float dt) {
-    if (streams.contains(playerId)) {
-        streams.at(playerId)->updateEstimator(dt);
+    if (auto stream = this->getStream(playerId)) {
+        stream->updateEstimator(dt);
     }
 }
 
 void VoicePlaybackManager::updateAllEstimators(float dt) {
-    for (const auto& [_, stream] : streams) {
+    auto s = streams.lock();
+    for (const auto& [_, stream] : s->active) {
         stream->updateEstimator(dt);
     }
 }
 
 float VoicePlaybackManager::getLoudness(int playerId) {
-    if (!streams.contains(playerId)) return 0.f;
+    auto stream = this->getStream(playerId);
+    if (!stream) return 0.f;
 
-    return streams.at(playerId)->getLoudness();
+    return stream->getLoudness();
 }
 
 util::time::time_point VoicePlaybackManager::getLastPlaybackTime(int playerId) {
-    if (!streams.contains(playerId)) return {};
+    auto stream = this->getStream(playerId);
+    if (!stream) return {};
 
-    return streams.at(playerId)->getLastPlaybackTime();
+    return stream->getLastPlaybackTime();
 }
 
 void VoicePlaybackManager::forEachStream(std::function<void(int, AudioStream&)> func) {
-    for (const auto& [accountId, stream] : streams) {
+    auto s = streams.lock();
+    for (const auto& [accountId, stream] : s->active) {
         func(accountId, *stream);
     }
 }
 
 #else
 
+VoicePlaybackManager::VoicePlaybackManager() {}
+VoicePlaybackManager::~VoicePlaybackManager() {}
 void VoicePlaybackManager::playRawDataStreamed(int playerId, const float* pcm, size_t samples) {}
 void VoicePlaybackManager::stopAllStreams() {}
 void VoicePlaybackManager::prepareStream(int playerId) {}
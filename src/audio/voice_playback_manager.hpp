@@ -3,18 +3,34 @@
 #include <defs/minimal_geode.hpp>
 
 #include "stream.hpp"
+#include "voice_mixer.hpp"
+#include <asp/sync.hpp>
+#include <asp/thread.hpp>
 #include <util/time.hpp>
 #include <util/singleton.hpp>
 
 /*
 * VoicePlaybackManager is responsible for playing voices of multiple people
 * at the same time efficiently and without memory leaks (?).
-* Not thread safe.
+*
+* Streams are created, removed and adjusted on the main thread only. Opus decoding happens on a separate voice decode thread,
+* which gets the frames through `queueFrameStreamed`, usually straight from the network thread, and plays them through the jitter buffer of each stream.
+* It decodes as the streams get played: the FMOD mixer thread wakes it up whenever a stream runs low on audio.
+*
+* With the voice mixer setting enabled, new streams don't get their own FMOD sound, and are all played through a single `VoiceMixer` instead.
 */
 class GLOBED_DLL VoicePlaybackManager : public SingletonBase<VoicePlaybackManager> {
+protected:
+    friend class SingletonBase;
+    VoicePlaybackManager();
+    ~VoicePlaybackManager();
+
 public:
 #ifdef GLOBED_VOICE_SUPPORT
-    Result<> playFrameStreamed(int playerId, const EncodedAudioFrame& frame);
+    // Queue a frame to be decoded and played on the voice decode thread, through the jitter buffer of the player's stream. Can be called from any thread.
+    // Frames of a player without a stream are not played, except the latest one, which is held until `prepareStream` is called for them.
+    // `sequence` is the number of the first opus frame, if the server sent one.
+    void queueFrameStreamed(int playerId, std::shared_ptr<const EncodedAudioFrame> frame, std::optional<uint16_t> sequence);
 #endif
     void playRawDataStreamed(int playerId, const float* pcm, size_t samples);
     void stopAllStreams();
@@ -33,10 +49,40 @@ public:
     float getLoudness(int playerId);
     util::time::time_point getLastPlaybackTime(int playerId);
 
+    // Calls `func` for every stream. Must not call other functions of this class.
     void forEachStream(std::function<void(int, AudioStream&)> func);
 
 private:
 #ifdef GLOBED_VOICE_SUPPORT
-    std::unordered_map<int, std::unique_ptr<AudioStream>> streams;
+    struct DecodeTask {
+        int playerId;
+        std::optional<uint16_t> sequence;
+        // null if the stream was just created and only the held back frame should be played, or if the stream only needs more audio
+        std::shared_ptr<const EncodedAudioFrame> frame;
+        util::time::time_point arrival;
+    };
+
+    struct Streams {
+        // shared with the decode thread, which may still be writing to a stream when it gets removed
+        std::unordered_map<int, std::shared_ptr<AudioStream>> active;
+        // the latest frame of every player that did not have a stream when it arrived
+        std::unordered_map<int, DecodeTask> heldBack;
+        // streams removed on the main thread that the decode thread may still be using.
+        // it hands them back to the main thread once it's done, so that they never get destroyed on the decode thread
+        std::vector<std::shared_ptr<AudioStream>> removed;
+    };
+
+    asp::Mutex<Streams> streams;
+    asp::Channel<DecodeTask> decodeQueue;
+    asp::Thread<VoicePlaybackManager*> decodeThread;
+    // only used by the decode thread
+    std::vector<std::shared_ptr<AudioStream>> playbackStreams;
+    // created on the main thread along with the first mixed stream, and destroyed once the last one is removed
+    std::unique_ptr<VoiceMixer> mixer;
+
+    void decodeThreadFunc(decltype(decodeThread)::StopToken&);
+    void handleDecodeTask(DecodeTask&& task);
+    void updatePlayback(AudioStream& stream, util::time::time_point now);
+    std::shared_ptr<AudioStream> getStream(int playerId);
 #endif
 };
@@ -46,17 +46,29 @@ void VoiceRecordingManager::threadFunc(decltype(thread)::StopToken&) {
                 return;
             }
 
-            auto result = vm.startPassiveRecording([](const auto& frame) {
+            auto result = vm.startPassiveRecording([this](const auto& frame) {
                 auto& nm = NetworkManager::get();
                 if (!nm.established()) return;
 
                 // `frame` does not live long enough and will be destructed at the end of this callback.
                 // so we can't pass it directly in a `VoicePacket` and we use a `RawPacket` instead.
 
+                // the skipped silent frames still take up sequence numbers, so the receiver knows how much time has passed
+                nextVoiceSequence += GlobedAudioManager::get().takeSuppressedFrames();
+
                 ByteBuffer buf;
+
+                if (nm.getSessionProtocol() < NetworkManager::PROTOCOL_SEQUENCED_VOICE) {
+                    buf.writeValue(frame);
+                    nm.send(RawPacket::create<VoicePacket>(std::move(buf)));
+                    return;
+                }
+
+                buf.writeU16(nextVoiceSequence);
                 buf.writeValue(frame);
+                nextVoiceSequence += frame.size();
 
-                nm.send(RawPacket::create<VoicePacket>(std::move(buf)));
+                nm.send(RawPacket::create<SequencedVoicePacket>(std::move(buf)));
             });
 
             if (result.isErr()) {
@@ -24,5 +24,10 @@ public:
     bool isRecording();
 
 private:
+#ifdef GLOBED_VOICE_SUPPORT
+    // number of the next opus frame sent in a `SequencedVoicePacket`, only used from the audio thread
+    uint16_t nextVoiceSequence = 0;
+#endif // GLOBED_VOICE_SUPPORT
+
     void resetBools(bool recording);
 };
@@ -5,20 +5,12 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-VolumeEstimator::VolumeEstimator(size_t sampleRate) {
-    this->sampleRate = sampleRate;
-}
-
-VolumeEstimator::VolumeEstimator() {
-    this->sampleRate = 0;
-}
+VolumeEstimator::VolumeEstimator(size_t sampleRate)
+    : sampleRate(sampleRate), sampleQueue(static_cast<size_t>(static_cast<float>(sampleRate) * BUFFER_SIZE)) {}
 
 void VolumeEstimator::feedData(const float* pcm, size_t samples) {
+    // if `update` falls behind, whatever does not fit is dropped
     sampleQueue.writeData(pcm, samples);
-
-    if (sampleQueue.size() > static_cast<float>(sampleRate) * BUFFER_SIZE) {
-        sampleQueue.clear();
-    }
 }
 
 void VolumeEstimator::update(float dt) {
@@ -36,6 +28,12 @@ void VolumeEstimator::update(float dt) {
     // yuck msvc
     float* buf = reinterpret_cast<float*>(alloca(sizeof(float) * needed));
 #endif
+    // only look at the most recent samples
+    size_t available = sampleQueue.size();
+    if (available > needed) {
+        sampleQueue.skip(available - needed);
+    }
+
     size_t copied = sampleQueue.copyTo(buf, needed);
 
     if (copied < needed) {
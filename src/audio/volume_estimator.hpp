@@ -3,19 +3,16 @@
 
 #ifdef GLOBED_VOICE_SUPPORT
 
-#include "sample_queue.hpp"
+#include "ring_buffer.hpp"
 #include <util/collections.hpp>
 
+// `feedData` may be called from a different thread than `update` and `getVolume`
 class GLOBED_DLL VolumeEstimator {
 public:
     VolumeEstimator(size_t sampleRate);
-    VolumeEstimator();
 
-    VolumeEstimator(const VolumeEstimator&) = default;
-    VolumeEstimator& operator=(const VolumeEstimator&) = default;
-
-    VolumeEstimator(VolumeEstimator&&) = default;
-    VolumeEstimator& operator=(VolumeEstimator&&) = default;
+    VolumeEstimator(const VolumeEstimator&) = delete;
+    VolumeEstimator& operator=(const VolumeEstimator&) = delete;
 
     void feedData(const float* pcm, size_t samples);
 
@@ -26,9 +23,9 @@ public:
 private:
     static constexpr float BUFFER_SIZE = 1.0f;
 
-    float volume;
+    float volume = 0.f;
     size_t sampleRate;
-    AudioSampleQueue sampleQueue;
+    AudioRingBuffer sampleQueue;
 };
 
 #endif // GLOBED_VOICE_SUPPORT
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <span>
 #include <string>
 #include <cstring> // std::memmove
 
 #include <defs/minimal_geode.hpp>
 #include <defs/assert.hpp>
+#include <util/crypto.hpp>
 #include <util/data.hpp>
 
 /*
@@ -18,6 +21,8 @@
 * constexpr size_t nonceLength();
 *
 * constexpr size_t macLength();
+*
+* and should use `nextNonce` instead of generating random nonces.
 */
 
 // this does not work bc c++ is shit
@@ -42,6 +47,9 @@ public:
 
     constexpr static size_t PREFIX_LEN = NONCE_LEN + MAC_LEN;
 
+    // A nonce is a random prefix unique to this box, followed by a 64-bit counter
+    constexpr static size_t NONCE_PREFIX_LEN = NONCE_LEN - sizeof(uint64_t);
+
     constexpr static size_t prefixLength() {
         return PREFIX_LEN;
     }
@@ -97,15 +105,23 @@ public:
 
     /* Decryption */
 
+    // Decrypt `size` bytes from `data` into itself, without moving the plaintext afterwards.
+    // Returns a span pointing at the plaintext, which starts `prefixLength()` bytes into `data`.
+    Result<std::span<byte>> decryptInPlaceView(byte* data, size_t size) {
+        // the plaintext goes exactly where the ciphertext is, so that neither the nonce nor the ciphertext get overwritten before they are read
+        GLOBED_UNWRAP_INTO(static_cast<Derived*>(this)->decryptInto(data, data + prefixLength(), size), size_t plaintext_size);
+
+        return Ok(std::span<byte>(data + prefixLength(), plaintext_size));
+    }
+
     // Decrypt `size` bytes from `data` into itself. Returns the length of the plaintext data.
+    // Prefer `decryptInPlaceView` if the plaintext does not have to start at `data`.
     Result<size_t> decryptInPlace(byte* data, size_t size) {
-        // overwriting nonce causes decryption to break
-        // so we offset the destination by NONCE_LEN and then move it back
-        GLOBED_UNWRAP_INTO(static_cast<Derived*>(this)->decryptInto(data, data + nonceLength(), size), size_t plaintext_size);
+        GLOBED_UNWRAP_INTO(this->decryptInPlaceView(data, size), auto plaintext);
 
-        std::memmove(data, data + nonceLength(), plaintext_size);
+        std::memmove(data, plaintext.data(), plaintext.size());
 
-        return Ok(plaintext_size);
+        return Ok(plaintext.size());
     }
 
     // Decrypt bytes from bytevector `src` and return a bytevector with the plaintext data.
@@ -136,4 +152,26 @@ public:
         GLOBED_UNWRAP_INTO(decrypt(src, size), auto vec);
         return Ok(std::string(vec.begin(), vec.end()));
     }
+
+protected:
+    BaseCryptoBox() {
+        util::crypto::secureRandom(noncePrefix, NONCE_PREFIX_LEN);
+    }
+
+    // Writes a nonce that was never used by this box into `dest`. Thread safe.
+    //
+    // Both sides of a connection encrypt with the same key, the random prefix is what keeps our nonces apart from the peer's.
+    // This is much cheaper than asking the OS for random bytes for every single packet.
+    void nextNonce(byte* dest) {
+        uint64_t counter = nonceCounter.fetch_add(1, std::memory_order::relaxed);
+
+        std::memcpy(dest, noncePrefix, NONCE_PREFIX_LEN);
+        for (size_t i = 0; i < sizeof(uint64_t); i++) {
+            dest[NONCE_PREFIX_LEN + i] = static_cast<byte>(counter >> (i * 8));
+        }
+    }
+
+private:
+    byte noncePrefix[NONCE_PREFIX_LEN];
+    std::atomic<uint64_t> nonceCounter = 0;
 };
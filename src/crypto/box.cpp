@@ -91,7 +91,7 @@ void CryptoBox::setPeerKey(const byte* key) {
 
 Result<size_t> CryptoBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
-    util::crypto::secureRandom(nonce, NONCE_LEN);
+    this->nextNonce(nonce);
 
     byte* ciphertext = dest + NONCE_LEN;
     CRYPTO_ERR_CHECK_SAFE(func_box_easy(ciphertext, src, size, nonce, sharedKey), "func_box_easy failed")
@@ -34,7 +34,7 @@ ChaChaSecretBox::~ChaChaSecretBox() {
 
 Result<size_t> ChaChaSecretBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
-    util::crypto::secureRandom(nonce, NONCE_LEN);
+    this->nextNonce(nonce);
 
     byte* mac = dest + NONCE_LEN;
     byte* ciphertext = mac + MAC_LEN;
@@ -34,7 +34,7 @@ SecretBox::~SecretBox() {
 
 Result<size_t> SecretBox::encryptInto(const byte* src, byte* dest, size_t size) {
     byte nonce[NONCE_LEN];
-    util::crypto::secureRandom(nonce, NONCE_LEN);
+    this->nextNonce(nonce);
 
     byte* ciphertext = dest + NONCE_LEN;
     CRYPTO_ERR_CHECK_SAFE(crypto_secretbox_easy(ciphertext, src, size, nonce, key), "crypto_secretbox_easy failed")
@@ -32,24 +32,66 @@ ByteBuffer::ByteBuffer(const byte* data, size_t length)
 ByteBuffer::ByteBuffer(bytevector&& data)
     : _data(std::move(data)) {}
 
-void ByteBuffer::rawWriteBytes(const byte* bytes, size_t length) {
-    // if we can't fit (i.e. writing at the end, just use insert)
-    if (_position + length > _data.size()) {
-        _data.insert(_data.begin() + _position, bytes, bytes + length);
-        // remove leftover elements
-        _data.reserve(_position + length);
-    } else {
-        // otherwise, overwrite existing elements
-        for (size_t i = 0; i < length; i++) {
-            _data.data()[_position + i] = bytes[i];
+ByteBuffer ByteBuffer::view(byte* data, size_t length) {
+    ByteBuffer buf;
+    buf._view = data;
+    buf._viewSize = length;
+    return buf;
+}
+
+void ByteBuffer::detach() {
+    if (!_view) return;
+
+    _data.assign(_view, _view + _viewSize);
+    _view = nullptr;
+    _viewSize = 0;
+}
+
+void ByteBuffer::rawWriteBytesSlow(const byte* bytes, size_t length) {
+    size_t end = _position + length;
+
+    if (_view) {
+        if (end <= _viewSize) {
+            std::memcpy(_view + _position, bytes, length);
+            _position = end;
+            return;
         }
+
+        this->detach();
     }
 
-    _position += length;
+    // if the write goes past the end, grow the vector first, then overwrite
+    if (end > _data.size()) {
+        _data.resize(end);
+    }
+
+    std::memcpy(_data.data() + _position, bytes, length);
+    _position = end;
+}
+
+byte* ByteBuffer::prepareWrite(size_t bytes) {
+    size_t end = _position + bytes;
+
+    if (_view && end > _viewSize) {
+        this->detach();
+    }
+
+    if (!_view && end > _data.size()) {
+        _data.resize(end);
+    }
+
+    byte* ptr = this->dataPtr() + _position;
+    _position = end;
+
+    return ptr;
+}
+
+void ByteBuffer::writeSpan(std::span<const byte> data) {
+    this->rawWriteBytes(data.data(), data.size());
 }
 
 DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
-    if (_position + count > _data.size()) {
+    if (_position + count > this->size()) {
         return Err(DecodeError::NotEnoughData);
     }
 
@@ -59,20 +101,28 @@ DecodeResult<> ByteBuffer::boundsCheck(size_t count) {
 /* Util methods */
 
 const bytevector& ByteBuffer::data() const {
+    GLOBED_REQUIRE(!_view, "attempted to get the underlying vector of a ByteBuffer view");
     return _data;
 }
 
 bytevector& ByteBuffer::data() {
+    this->detach();
     return _data;
 }
 
+bool ByteBuffer::isView() const {
+    return _view != nullptr;
+}
+
 void ByteBuffer::clear() {
     _data.clear();
+    _view = nullptr;
+    _viewSize = 0;
     _position = 0;
 }
 
 size_t ByteBuffer::size() const {
-    return _data.size();
+    return _view ? _viewSize : _data.size();
 }
 
 size_t ByteBuffer::getPosition() const {
@@ -84,9 +134,29 @@ void ByteBuffer::setPosition(size_t pos) {
 }
 
 void ByteBuffer::resize(size_t newSize) {
+    // shrinking a view needs no copy, we just forget about the tail
+    if (_view && newSize <= _viewSize) {
+        _viewSize = newSize;
+        return;
+    }
+
+    this->detach();
     _data.resize(newSize);
 }
 
+void ByteBuffer::reserve(size_t capacity) {
+    if (_view && capacity <= _viewSize) {
+        return;
+    }
+
+    this->detach();
+    _data.reserve(capacity);
+}
+
+size_t ByteBuffer::capacity() const {
+    return _view ? _viewSize : _data.capacity();
+}
+
 void ByteBuffer::grow(size_t bytes) {
     this->resize(this->size() + bytes);
 }
@@ -104,7 +174,7 @@ DecodeResult<> ByteBuffer::skip(size_t bytes) {
 
 DecodeResult<> ByteBuffer::readBytesInto(byte* buf, size_t bytes) {
     GLOBED_UNWRAP(this->boundsCheck(bytes));
-    std::memcpy(buf, _data.data() + _position, bytes);
+    std::memcpy(buf, this->dataPtr() + _position, bytes);
     _position += bytes;
 
     return Ok();
@@ -123,12 +193,20 @@ template<> void ByteBuffer::customEncode(const std::string& value) {
     this->customEncode(std::string_view(value));
 }
 
+template<> size_t ByteBuffer::customEncodedSize(const std::string_view& value) {
+    return sizeof(length_t) + value.size();
+}
+
+template<> size_t ByteBuffer::customEncodedSize(const std::string& value) {
+    return sizeof(length_t) + value.size();
+}
+
 template<> DecodeResult<std::string> ByteBuffer::customDecode() {
     GLOBED_UNWRAP_INTO(this->readLength(), size_t length);
 
     GLOBED_UNWRAP(this->boundsCheck(length));
 
-    std::string str(reinterpret_cast<const char*>(_data.data() + _position), length);
+    std::string str(reinterpret_cast<const char*>(this->dataPtr() + _position), length);
     _position += length;
 
     return Ok(std::move(str));
@@ -3,6 +3,8 @@
 #include <defs/minimal_geode.hpp>
 
 #include <type_traits>
+#include <optional>
+#include <span>
 #include <fmt/format.h>
 #include <asp/data/util.hpp>
 #include <asp/misc/traits.hpp>
@@ -44,6 +46,10 @@ public:
     // Take ownership of the given `bytevector` and construct a `ByteBuffer` from the data
     ByteBuffer(util::data::bytevector&& data);
 
+    // Construct a non-owning `ByteBuffer` that reads and writes `length` bytes at `data` in place, without copying them.
+    // The memory must outlive the buffer (and any copies of it). Growing past `length` bytes turns it into an owning buffer.
+    static ByteBuffer view(util::data::byte* data, size_t length);
+
     ByteBuffer(const ByteBuffer& other) = default;
     ByteBuffer& operator=(const ByteBuffer& other) = default;
 
@@ -87,6 +93,111 @@ public:
         }
     }
 
+    // Returns the size of `T` once encoded, if it does not depend on the value (no strings, vectors, optionals, etc.)
+    template <typename T>
+    static constexpr std::optional<size_t> staticEncodedSize() {
+        if constexpr (util::data::IsPrimitive<T>) {
+            return sizeof(T);
+        } else if constexpr (std::is_enum_v<T>) {
+            return sizeof(std::underlying_type_t<T>);
+        } else if constexpr (std::is_empty_v<T> && std::is_default_constructible_v<T>) {
+            return 0;
+        } else if constexpr (boost::describe::has_describe_members<T>::value) {
+            return reflectionStaticSize<T>();
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            constexpr auto first = staticEncodedSize<typename T::first_type>();
+            constexpr auto second = staticEncodedSize<typename T::second_type>();
+
+            if constexpr (first.has_value() && second.has_value()) {
+                return first.value() + second.value();
+            } else {
+                return std::nullopt;
+            }
+        } else {
+            return CustomStaticSize<T>::value;
+        }
+    }
+
+    // Returns whether `T` consists only of primitives, enums, bitfields and other such structs.
+    // Those types are encoded and decoded with a single bounds check and no per-field `Result`s.
+    template <typename T>
+    static constexpr bool isFixedLayout() {
+        if constexpr (util::data::IsPrimitive<T> || std::is_enum_v<T>) {
+            return true;
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            return isFixedLayout<typename T::first_type>() && isFixedLayout<typename T::second_type>();
+        } else if constexpr (boost::describe::has_describe_members<T>::value && std::is_default_constructible_v<T>) {
+            if constexpr (isBitfield<T>()) {
+                return true;
+            }
+
+            bool fixed = true;
+
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                using MPT = decltype(descriptor.pointer);
+                using FT = typename asp::member_ptr_to_underlying<MPT>::type;
+
+                if constexpr (!isFixedLayout<FT>()) {
+                    fixed = false;
+                }
+            });
+
+            return fixed;
+        } else {
+            return false;
+        }
+    }
+
+    // Returns the exact amount of bytes that `writeValue(value)` would write
+    template <typename T>
+    static size_t encodedSize(const T& value) {
+        if constexpr (staticEncodedSize<T>().has_value()) {
+            return staticEncodedSize<T>().value();
+        } else if constexpr (boost::describe::has_describe_members<T>::value) {
+            size_t total = 0;
+
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                total += encodedSize(value.*descriptor.pointer);
+            });
+
+            return total;
+        } else if constexpr (asp::is_std_vector<T>::value) {
+            using E = typename T::value_type;
+            size_t total = sizeof(length_t);
+
+            if constexpr (staticEncodedSize<E>().has_value()) {
+                total += value.size() * staticEncodedSize<E>().value();
+            } else {
+                for (const auto& elem : value) {
+                    total += encodedSize(elem);
+                }
+            }
+
+            return total;
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            return encodedSize(value.first) + encodedSize(value.second);
+        } else if constexpr (asp::is_std_optional<T>::value) {
+            return sizeof(bool) + (value.has_value() ? encodedSize(value.value()) : 0);
+        } else if constexpr (util::misc::is_either<T>::value) {
+            return sizeof(bool) + (value.isFirst() ? encodedSize(value.firstRef()->get()) : encodedSize(value.secondRef()->get()));
+        } else if constexpr (std::is_same_v<T, ByteBuffer>) {
+            return value.size();
+        } else {
+            // this will raise a linker error if `customEncodedSize` is not specialized for T.
+            return customEncodedSize<T>(value);
+        }
+    }
+
+    // Returns the encoded size of a commonly encodable type. Must be specialized for every type that has a `customEncode` specialization,
+    // unless it always encodes to the same amount of bytes, in which case `CustomStaticSize` can be specialized instead.
+    template <typename T>
+    static size_t customEncodedSize(const T& value);
+
+    template <typename T>
+    struct CustomStaticSize {
+        static constexpr std::optional<size_t> value = std::nullopt;
+    };
+
     // Read a commonly encodable type. Can be specialized for any type to enable decoding ability.
     template <typename T>
     DecodeResult<T> customDecode();
@@ -97,12 +208,24 @@ public:
 
     /* Various helper methods */
 
-    // Get the underlying data buffer of this `ByteBuffer`
+    // Get the underlying data buffer of this `ByteBuffer`. Throws if this is a view.
     const util::data::bytevector& data() const;
 
-    // Get the underlying data buffer of this `ByteBuffer`
+    // Get the underlying data buffer of this `ByteBuffer`. If this is a view, the data is copied into an owned buffer first.
     util::data::bytevector& data();
 
+    // Get a pointer to the start of the data. Unlike `data()`, this never copies, so it's fine to use on views.
+    util::data::byte* dataPtr() {
+        return _view ? _view : _data.data();
+    }
+
+    const util::data::byte* dataPtr() const {
+        return _view ? _view : _data.data();
+    }
+
+    // Returns whether this buffer borrows memory it does not own (see `ByteBuffer::view`)
+    bool isView() const;
+
     // Clear all the data in this buffer
     void clear();
 
@@ -118,6 +241,12 @@ public:
     // Resize the internal buffer to `newSize` bytes
     void resize(size_t newSize);
 
+    // Make sure at least `capacity` bytes can be stored without reallocating
+    void reserve(size_t capacity);
+
+    // Get the amount of bytes that can be stored without reallocating
+    size_t capacity() const;
+
     // Equivalent to `resize(size() + bytes)`
     void grow(size_t bytes);
 
@@ -173,9 +302,11 @@ public:
         return Ok(BitBuffer<N>(underlying));
     }
 
-    /* Raw reads */
+    /* Raw reads/writes */
     DecodeResult<> readBytesInto(util::data::byte* buf, size_t bytes);
 
+    void writeSpan(std::span<const util::data::byte> data);
+
 protected:
     // Read `sizeof(T)` bytes and reinterpret them as `T`. No endianness conversions are done.
     template <typename T>
@@ -183,7 +314,7 @@ protected:
         GLOBED_UNWRAP(this->boundsCheck(sizeof(T)));
 
         T value;
-        std::memcpy(&value, _data.data() + _position, sizeof(T));
+        std::memcpy(&value, this->dataPtr() + _position, sizeof(T));
         _position += sizeof(T);
 
         return Ok(value);
@@ -198,7 +329,20 @@ protected:
     }
 
     // Like `rawWrite` but accepts a raw buffer
-    void rawWriteBytes(const util::data::byte* bytes, size_t length);
+    void rawWriteBytes(const util::data::byte* bytes, size_t length) {
+        // fast path, appending to the end of an owned buffer.
+        // inserting at the end is a plain memcpy when there's enough capacity, and grows the vector geometrically otherwise
+        if (!_view && _position == _data.size()) [[likely]] {
+            _data.insert(_data.end(), bytes, bytes + length);
+            _position += length;
+            return;
+        }
+
+        this->rawWriteBytesSlow(bytes, length);
+    }
+
+    // Overwriting existing data, or writing into a view
+    void rawWriteBytesSlow(const util::data::byte* bytes, size_t length);
 
     // Read a primitive `T`, performing endianness conversions
     template <typename T>
@@ -283,6 +427,17 @@ protected:
             checkMissingFields<T>();
         }
 
+        if constexpr (isFixedLayout<T>()) {
+            GLOBED_UNWRAP(this->boundsCheck(staticEncodedSize<T>().value()));
+
+            T value;
+            if (!this->readFixedUnchecked(value)) {
+                return Err(DecodeError::InvalidEnumValue);
+            }
+
+            return Ok(std::move(value));
+        }
+
         // create a default initialized instance
         T value;
 
@@ -331,11 +486,107 @@ protected:
             checkMissingFields<T>();
         }
 
+        if constexpr (isFixedLayout<T>()) {
+            util::data::byte* dest = this->prepareWrite(staticEncodedSize<T>().value());
+            this->writeFixedUnchecked(value, dest);
+            return;
+        }
+
         boost::mp11::mp_for_each<Md>([&, this](auto descriptor) {
             this->writeValue(value.*descriptor.pointer);
         });
     }
 
+    template <typename T, class Bd = boost::describe::describe_bases<T, boost::describe::mod_any_access>>
+    constexpr static bool isBitfield() {
+        if constexpr (!boost::mp11::mp_empty<Bd>::value) {
+            return std::is_same_v<typename boost::mp11::mp_first<Bd>::type, BitfieldBase>;
+        } else {
+            return false;
+        }
+    }
+
+    // Make room for `bytes` bytes at the current position, advance the position and return a pointer to the start of that region
+    util::data::byte* prepareWrite(size_t bytes);
+
+    // Read a fixed layout type (see `isFixedLayout`) without any bounds checks, the caller must ensure enough data is available.
+    // Returns false if an invalid enum value was encountered.
+    template <typename T>
+    bool readFixedUnchecked(T& out) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            std::memcpy(&out, this->dataPtr() + _position, sizeof(T));
+            _position += sizeof(T);
+            out = util::data::maybeByteswap(out);
+            return true;
+        } else if constexpr (std::is_enum_v<T>) {
+            using P = std::underlying_type_t<T>;
+
+            P underlying;
+            this->readFixedUnchecked(underlying);
+
+            bool foundMatch = false;
+            boost::mp11::mp_for_each<boost::describe::describe_enumerators<T>>([&](auto descriptor) {
+                if (static_cast<P>(descriptor.value) == underlying) {
+                    foundMatch = true;
+                }
+            });
+
+            out = static_cast<T>(underlying);
+            return foundMatch;
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            bool ok = this->readFixedUnchecked(out.first);
+            return this->readFixedUnchecked(out.second) && ok;
+        } else if constexpr (isBitfield<T>()) {
+            constexpr size_t bitcount = util::data::bitsToBytes(sizeof(T)) * 8;
+
+            BitBufferUnderlyingType<bitcount> underlying;
+            this->readFixedUnchecked(underlying);
+
+            BitBuffer<bitcount> bits(underlying);
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                out.*descriptor.pointer = bits.readBit();
+            });
+
+            return true;
+        } else {
+            bool ok = true;
+
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&, this](auto descriptor) {
+                ok = this->readFixedUnchecked(out.*descriptor.pointer) && ok;
+            });
+
+            return ok;
+        }
+    }
+
+    // Write a fixed layout type (see `isFixedLayout`) into `dest` and advance it. `dest` must have enough space for the value.
+    template <typename T>
+    static void writeFixedUnchecked(const T& value, util::data::byte*& dest) {
+        if constexpr (util::data::IsPrimitive<T>) {
+            T swapped = util::data::maybeByteswap(value);
+            std::memcpy(dest, &swapped, sizeof(T));
+            dest += sizeof(T);
+        } else if constexpr (std::is_enum_v<T>) {
+            writeFixedUnchecked(static_cast<std::underlying_type_t<T>>(value), dest);
+        } else if constexpr (asp::is_std_pair<T>::value) {
+            writeFixedUnchecked(value.first, dest);
+            writeFixedUnchecked(value.second, dest);
+        } else if constexpr (isBitfield<T>()) {
+            constexpr size_t bitcount = util::data::bitsToBytes(sizeof(T)) * 8;
+
+            BitBuffer<bitcount> bits;
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                bits.writeBit(value.*descriptor.pointer);
+            });
+
+            writeFixedUnchecked(bits.contents(), dest);
+        } else {
+            boost::mp11::mp_for_each<boost::describe::describe_members<T, boost::describe::mod_public>>([&](auto descriptor) {
+                writeFixedUnchecked(value.*descriptor.pointer, dest);
+            });
+        }
+    }
+
     template <
         typename T,
         class Md = boost::describe::describe_members<T, boost::describe::mod_public>
@@ -410,7 +661,7 @@ protected:
         } else if constexpr (util::misc::is_either<T>::value) {
             this->pcEncodeEither(value);
         } else if constexpr (std::is_same_v<T, ByteBuffer>) {
-            this->rawWriteBytes(value.data().data(), value.size());
+            this->rawWriteBytes(value.dataPtr(), value.size());
         } else {
             this->customEncode(value);
         }
@@ -424,6 +675,20 @@ protected:
 
         std::vector<T> out;
 
+        if constexpr (isFixedLayout<T>() && staticEncodedSize<T>().value() > 0) {
+            // check the bounds for all elements at once, afterwards the length can be trusted
+            GLOBED_UNWRAP(this->boundsCheck(length * staticEncodedSize<T>().value()));
+
+            out.resize(length);
+            for (auto& elem : out) {
+                if (!this->readFixedUnchecked(elem)) {
+                    return Err(DecodeError::InvalidEnumValue);
+                }
+            }
+
+            return Ok(std::move(out));
+        }
+
         if (sizeof(T) * length < (2 << 15)) {
             out.reserve(length);
         }
@@ -440,6 +705,15 @@ protected:
     void pcEncodeVector(const std::vector<T>& vec) {
         this->writeLength(vec.size());
 
+        if constexpr (isFixedLayout<T>()) {
+            util::data::byte* dest = this->prepareWrite(vec.size() * staticEncodedSize<T>().value());
+            for (const auto& elem : vec) {
+                writeFixedUnchecked(elem, dest);
+            }
+
+            return;
+        }
+
         for (const auto& elem : vec) {
             this->writeValue<T>(elem);
         }
@@ -550,6 +824,37 @@ protected:
         return total;
     }
 
+    template <
+        typename T,
+        class Md = boost::describe::describe_members<T, boost::describe::mod_public>
+    >
+    constexpr static std::optional<size_t> reflectionStaticSize() {
+        if constexpr (isBitfield<T>()) {
+            return sizeof(BitBufferUnderlyingType<util::data::bitsToBytes(sizeof(T)) * 8>);
+        }
+
+        size_t total = 0;
+        bool dynamic = false;
+
+        boost::mp11::mp_for_each<Md>([&](auto descriptor) {
+            using MPT = decltype(descriptor.pointer);
+            using FT = typename asp::member_ptr_to_underlying<MPT>::type;
+
+            constexpr auto size = staticEncodedSize<FT>();
+            if constexpr (size.has_value()) {
+                total += size.value();
+            } else {
+                dynamic = true;
+            }
+        });
+
+        if (dynamic) {
+            return std::nullopt;
+        }
+
+        return total;
+    }
+
     template <typename T>
     constexpr static void checkMissingFields() {
         static_assert(calculateStructSize<T>() == sizeof(T), "size of the type does not match the sizes of all fields, make sure fields are listed in the correct order and there are no missing fields");
@@ -558,7 +863,38 @@ protected:
 private:
     // Data members
     util::data::bytevector _data;
+    // when not null, the buffer is a view and `_data` is unused
+    util::data::byte* _view = nullptr;
+    size_t _viewSize = 0;
     size_t _position = 0;
+
+    // Copy the viewed memory into `_data` and stop borrowing it
+    void detach();
+};
+
+template <>
+struct ByteBuffer::CustomStaticSize<cocos2d::CCPoint> {
+    static constexpr std::optional<size_t> value = sizeof(float) * 2;
+};
+
+template <>
+struct ByteBuffer::CustomStaticSize<cocos2d::CCSize> {
+    static constexpr std::optional<size_t> value = sizeof(float) * 2;
+};
+
+template <>
+struct ByteBuffer::CustomStaticSize<cocos2d::ccColor3B> {
+    static constexpr std::optional<size_t> value = 3;
+};
+
+template <>
+struct ByteBuffer::CustomStaticSize<cocos2d::ccColor4B> {
+    static constexpr std::optional<size_t> value = 4;
+};
+
+template <size_t N>
+struct ByteBuffer::CustomStaticSize<util::data::bytearray<N>> {
+    static constexpr std::optional<size_t> value = N;
 };
 
 // Custom error formatter
@@ -60,6 +60,19 @@ class VoicePacket : public Packet {
 };
 GLOBED_SERIALIZABLE_STRUCT(VoicePacket, (frame));
 
+// 12012 - SequencedVoicePacket
+class SequencedVoicePacket : public Packet {
+    GLOBED_PACKET(12012, SequencedVoicePacket, true, false)
+
+    SequencedVoicePacket() {}
+    SequencedVoicePacket(uint16_t sequence, std::shared_ptr<EncodedAudioFrame> _frame) : sequence(sequence), frame(_frame) {}
+
+    // number of the first opus frame in `frame`, the rest are numbered consecutively
+    uint16_t sequence;
+    std::shared_ptr<EncodedAudioFrame> frame;
+};
+GLOBED_SERIALIZABLE_STRUCT(SequencedVoicePacket, (sequence, frame));
+
 #endif // GLOBED_VOICE_SUPPORT
 
 // 12011 - ChatMessagePacket
@@ -35,6 +35,10 @@ public:
         throw std::runtime_error("RawPacket cannot be decoded");
     }
 
+    size_t encodedSize() const override {
+        return buffer.size();
+    }
+
     static std::shared_ptr<Packet> create(packetid_t id, bool encrypted, bool tcp, ByteBuffer&& buffer) {
         return std::make_shared<RawPacket>(id, encrypted, tcp, std::move(buffer));
     }
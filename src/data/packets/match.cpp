@@ -35,7 +35,9 @@ std::shared_ptr<Packet> matchPacket(packetid_t packetId) {
         PACKET(PlayerProfilesPacket);
         PACKET(LevelDataPacket);
         PACKET(LevelPlayerMetadataPacket);
+        PACKET(SequencedLevelDataPacket);
         PACKET(VoiceBroadcastPacket);
+        PACKET(SequencedVoiceBroadcastPacket);
         PACKET(ChatMessageBroadcastPacket);
 
         // room related
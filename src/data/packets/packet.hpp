@@ -25,6 +25,11 @@ using packetid_t = uint16_t;
         GLOBED_UNWRAP_INTO(buf.readValue<std::remove_reference_t<decltype(*this)>>(), *this); \
         return Ok(); \
     } \
+    size_t encodedSize() const override { \
+        using InstTy = typename std::remove_reference_t<decltype(*this)>; \
+        using NonCvTy = typename std::remove_cv_t<InstTy>; \
+        return ByteBuffer::encodedSize<NonCvTy>(*this); \
+    } \
     template <typename... Args> \
     static std::shared_ptr<Packet> create(Args&&... args) { \
         return std::make_shared<name>(std::forward<Args>(args)...); \
@@ -38,6 +43,9 @@ public:
     // Decodes the packet from a bytebuffer
     virtual ByteBuffer::DecodeResult<> decode(ByteBuffer& buf) = 0;
 
+    // Returns the amount of bytes `encode` will write
+    virtual size_t encodedSize() const = 0;
+
     virtual packetid_t getPacketId() const = 0;
     virtual bool getUseTcp() const = 0;
     virtual bool getEncrypted() const = 0;
@@ -35,6 +35,18 @@ class LevelPlayerMetadataPacket : public Packet {
 
 GLOBED_SERIALIZABLE_STRUCT(LevelPlayerMetadataPacket, (players));
 
+// 22003 - SequencedLevelDataPacket
+class SequencedLevelDataPacket : public Packet {
+    GLOBED_PACKET(22003, SequencedLevelDataPacket, false, false)
+
+    SequencedLevelDataPacket() {}
+
+    uint16_t sequence;
+    std::vector<AssociatedPlayerData> players;
+};
+
+GLOBED_SERIALIZABLE_STRUCT(SequencedLevelDataPacket, (sequence, players));
+
 #ifdef GLOBED_VOICE_SUPPORT
 # include <audio/frame.hpp>
 #endif
@@ -57,6 +69,26 @@ class VoiceBroadcastPacket : public Packet {
     GLOBED_SERIALIZABLE_STRUCT(VoiceBroadcastPacket, ());
 #endif // GLOBED_VOICE_SUPPORT
 
+// 22012 - SequencedVoiceBroadcastPacket
+class SequencedVoiceBroadcastPacket : public Packet {
+    GLOBED_PACKET(22012, SequencedVoiceBroadcastPacket, true, false)
+
+    SequencedVoiceBroadcastPacket() {}
+
+#ifdef GLOBED_VOICE_SUPPORT
+    int sender;
+    // number of the first opus frame in `frame`, as sent by the sender
+    uint16_t sequence;
+    EncodedAudioFrame frame;
+#endif
+};
+
+#ifdef GLOBED_VOICE_SUPPORT
+    GLOBED_SERIALIZABLE_STRUCT(SequencedVoiceBroadcastPacket, (sender, sequence, frame));
+#else
+    GLOBED_SERIALIZABLE_STRUCT(SequencedVoiceBroadcastPacket, ());
+#endif // GLOBED_VOICE_SUPPORT
+
 // 22011 - ChatMessageBroadcastPacket
 class ChatMessageBroadcastPacket : public Packet {
     GLOBED_PACKET(22011, ChatMessageBroadcastPacket, true, false)
@@ -19,30 +19,71 @@ void SpecificIconData::copyFlagsFrom(const SpecificIconData& other) {
     isSideways = other.isSideways;
 }
 
+uint16_t SpecificIconData::flagBits() const {
+    BitBuffer<16> bits;
+    bits.writeBits(
+        isVisible,
+        isLookingLeft,
+        isUpsideDown,
+        isDashing,
+        isMini,
+        isGrounded,
+        isStationary,
+        isFalling,
+        didJustJump,
+        isRotating,
+        isSideways
+    );
+
+    return bits.contents();
+}
+
+void SpecificIconData::setFlagBits(uint16_t value) {
+    BitBuffer<16> bits(value);
+    bits.readBitsInto(
+        isVisible,
+        isLookingLeft,
+        isUpsideDown,
+        isDashing,
+        isMini,
+        isGrounded,
+        isStationary,
+        isFalling,
+        didJustJump,
+        isRotating,
+        isSideways
+    );
+}
+
+uint8_t PlayerData::flagBits() const {
+    BitBuffer<8> bits;
+    bits.writeBits(isDead, isPaused, isPracticing, isDualMode, isInEditor, isEditorBuilding, isLastDeathReal);
+    return bits.contents();
+}
+
+void PlayerData::setFlagBits(uint8_t value) {
+    BitBuffer<8> bits(value);
+    bits.readBitsInto(isDead, isPaused, isPracticing, isDualMode, isInEditor, isEditorBuilding, isLastDeathReal);
+}
+
 template<> void ByteBuffer::customEncode(const SpecificIconData& data) {
     this->writeValue(data.position);
     this->writeValue(data.rotation);
     this->writeValue(data.iconType);
 
-    BitBuffer<16> bits;
-    bits.writeBits(
-        data.isVisible,
-        data.isLookingLeft,
-        data.isUpsideDown,
-        data.isDashing,
-        data.isMini,
-        data.isGrounded,
-        data.isStationary,
-        data.isFalling,
-        data.didJustJump,
-        data.isRotating,
-        data.isSideways
-    );
-    this->writeBits(bits);
+    this->writeBits(BitBuffer<16>(data.flagBits()));
 
     this->writeValue(data.spiderTeleportData);
 }
 
+template<> size_t ByteBuffer::customEncodedSize(const SpecificIconData& data) {
+    return encodedSize(data.position)
+        + encodedSize(data.rotation)
+        + encodedSize(data.iconType)
+        + sizeof(BitBufferUnderlyingType<16>)
+        + encodedSize(data.spiderTeleportData);
+}
+
 template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode() {
     SpecificIconData data;
 
@@ -51,19 +92,7 @@ template<> ByteBuffer::DecodeResult<SpecificIconData> ByteBuffer::customDecode()
     GLOBED_UNWRAP_INTO(this->readValue<PlayerIconType>(), data.iconType);
 
     GLOBED_UNWRAP_INTO(this->readBits<16>(), auto bits);
-    bits.readBitsInto(
-        data.isVisible,
-        data.isLookingLeft,
-        data.isUpsideDown,
-        data.isDashing,
-        data.isMini,
-        data.isGrounded,
-        data.isStationary,
-        data.isFalling,
-        data.didJustJump,
-        data.isRotating,
-        data.isSideways
-    );
+    data.setFlagBits(bits.contents());
 
     GLOBED_UNWRAP_INTO(this->readValue<std::optional<SpiderTeleportData>>(), data.spiderTeleportData);
 
@@ -77,9 +106,16 @@ template<> void ByteBuffer::customEncode(const PlayerData& data) {
     this->writeValue(data.lastDeathTimestamp);
     this->writeValue(data.currentPercentage);
 
-    BitBuffer<8> bits;
-    bits.writeBits(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal);
-    this->writeBits(bits);
+    this->writeBits(BitBuffer<8>(data.flagBits()));
+}
+
+template<> size_t ByteBuffer::customEncodedSize(const PlayerData& data) {
+    return encodedSize(data.timestamp)
+        + encodedSize(data.player1)
+        + encodedSize(data.player2)
+        + encodedSize(data.lastDeathTimestamp)
+        + encodedSize(data.currentPercentage)
+        + sizeof(BitBufferUnderlyingType<8>);
 }
 
 template<> ByteBuffer::DecodeResult<PlayerData> ByteBuffer::customDecode() {
@@ -92,7 +128,7 @@ template<> ByteBuffer::DecodeResult<PlayerData> ByteBuffer::customDecode() {
     GLOBED_UNWRAP_INTO(this->readValue<float>(), data.currentPercentage);
 
     GLOBED_UNWRAP_INTO(this->readBits<8>(), auto bits);
-    bits.readBitsInto(data.isDead, data.isPaused, data.isPracticing, data.isDualMode, data.isInEditor, data.isEditorBuilding, data.isLastDeathReal);
+    data.setFlagBits(bits.contents());
 
     return Ok(data);
 }
@@ -25,6 +25,10 @@ GLOBED_SERIALIZABLE_STRUCT(SpiderTeleportData, (from, to));
 struct SpecificIconData {
     void copyFlagsFrom(const SpecificIconData& other);
 
+    // Packs the boolean flags in the same order they are encoded in
+    uint16_t flagBits() const;
+    void setFlagBits(uint16_t bits);
+
     cocos2d::CCPoint position;
     float rotation;
 
@@ -45,6 +49,10 @@ struct SpecificIconData {
 };
 
 struct PlayerData {
+    // Packs the boolean flags in the same order they are encoded in
+    uint8_t flagBits() const;
+    void setFlagBits(uint8_t bits);
+
     float timestamp;
 
     SpecificIconData player1;
@@ -4,6 +4,7 @@
 /*
 * GLOBED_SOCKET_POLL - poll function
 * GLOBED_SOCKET_POLLFD - pollfd structure
+* GLOBED_SOCKET_MMSG - defined if recvmmsg and sendmmsg are available (Linux and Android)
 */
 
 #ifdef GEODE_IS_WINDOWS
@@ -16,4 +17,8 @@
 # define GLOBED_SOCKET_POLL ::poll
 # define GLOBED_SOCKET_POLLFD struct pollfd
 
+# ifdef __linux__
+#  define GLOBED_SOCKET_MMSG 1
+# endif
+
 #endif
@@ -28,6 +28,14 @@ bool PlayerInterpolator::hasPlayer(int playerId) {
 void PlayerInterpolator::updatePlayer(int playerId, const PlayerData& data, float updateCounter) {
     auto& player = players.at(playerId);
     player.updateCounter = updateCounter;
+
+    // servers older than protocol 13 send `LevelDataPacket` without sequence numbers, so there a frame that got reordered
+    // behind a newer one is only recognizable by its timestamp. applying it would move the player back in time
+    if (player.totalFrames > 0 && data.timestamp < player.lastTimestamp) {
+        return;
+    }
+
+    player.lastTimestamp = data.timestamp;
     player.pendingRealFrame = true;
     player.totalFrames++;
 
@@ -59,6 +59,7 @@ public:
         float updateCounter = 0.0f;
         float timeCounter = 0.0f;
         float lastDeathTimestamp = 0.0f;
+        float lastTimestamp = 0.0f; // of the newest frame applied, older ones that arrive after it are dropped
         size_t totalFrames = 0;
 
         LerpFrame olderFrame, newerFrame;
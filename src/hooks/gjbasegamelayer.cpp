@@ -247,6 +247,7 @@ void GlobedGJBGL::setupAudio() {
 
         // set the record buffer size
         vm.setRecordBufferCapacity(settings.communication.lowerAudioLatency ? EncodedAudioFrame::LIMIT_LOW_LATENCY : EncodedAudioFrame::LIMIT_REGULAR);
+        vm.setSilenceSuppression(settings.communication.silenceSuppression, settings.communication.silenceHangover);
 
         // start passive voice recording
         auto& vrm = VoiceRecordingManager::get();
@@ -284,20 +285,15 @@ void GlobedGJBGL::setupPacketListeners() {
         }
     });
 
+    // every packet has the full state of all players, so after a hitch only the newest one matters
     nm.addListener<LevelDataPacket>(this, [this](std::shared_ptr<LevelDataPacket> packet){
-        auto& fields = this->getFields();
+        this->handleLevelData(packet->players);
+    }, 0, false, true);
 
-        fields.lastServerUpdate = fields.timeCounter;
-
-        for (const auto& player : packet->players) {
-            if (!fields.players.contains(player.accountId)) {
-                // new player joined
-                this->handlePlayerJoin(player.accountId);
-            }
-
-            fields.interpolator->updatePlayer(player.accountId, player.data, fields.lastServerUpdate);
-        }
-    });
+    // packets that arrived late or twice are already dropped by the network manager
+    nm.addListener<SequencedLevelDataPacket>(this, [this](std::shared_ptr<SequencedLevelDataPacket> packet){
+        this->handleLevelData(packet->players);
+    }, 0, false, true);
 
     nm.addListener<LevelPlayerMetadataPacket>(this, [this](std::shared_ptr<LevelPlayerMetadataPacket> packet) {
         for (const auto& player : packet->players) {
@@ -313,26 +309,13 @@ void GlobedGJBGL::setupPacketListeners() {
 
     nm.addListener<VoiceBroadcastPacket>(this, [this](std::shared_ptr<VoiceBroadcastPacket> packet) {
 #ifdef GLOBED_VOICE_SUPPORT
-        // if deafened or voice is disabled, do nothing
-        auto& settings = GlobedSettings::get();
-
-        if (this->m_fields->deafened || !settings.communication.voiceEnabled) return;
-        if (!this->shouldLetMessageThrough(packet->sender)) return;
-
-        auto& vpm = VoicePlaybackManager::get();
-        try {
-            vpm.prepareStream(packet->sender);
-
-            vpm.setVolume(packet->sender, settings.communication.voiceVolume);
-            this->updateProximityVolume(packet->sender);
-            auto result = vpm.playFrameStreamed(packet->sender, packet->frame);
+        this->handleVoiceFrame(packet->sender);
+#endif // GLOBED_VOICE_SUPPORT
+    });
 
-            if (result.isErr()) {
-                ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + result.unwrapErr());
-            }
-        } catch(const std::exception& e) {
-            ErrorQueues::get().debugWarn(std::string("Failed to play a voice frame: ") + e.what());
-        }
+    nm.addListener<SequencedVoiceBroadcastPacket>(this, [this](std::shared_ptr<SequencedVoiceBroadcastPacket> packet) {
+#ifdef GLOBED_VOICE_SUPPORT
+        this->handleVoiceFrame(packet->sender);
 #endif // GLOBED_VOICE_SUPPORT
     });
 
@@ -937,6 +920,29 @@ bool GlobedGJBGL::shouldLetMessageThrough(int playerId) {
     return true;
 }
 
+void GlobedGJBGL::handleVoiceFrame(int playerId) {
+#ifdef GLOBED_VOICE_SUPPORT
+    // the frame itself is decoded on the voice decode thread, here we only decide whether it gets played, and how loud.
+    auto& settings = GlobedSettings::get();
+    auto& vpm = VoicePlaybackManager::get();
+
+    // if deafened or voice is disabled, drop the stream so that the decode thread has nowhere to write to
+    if (m_fields->deafened || !settings.communication.voiceEnabled || !this->shouldLetMessageThrough(playerId)) {
+        vpm.removeStream(playerId);
+        return;
+    }
+
+    try {
+        vpm.prepareStream(playerId);
+
+        vpm.setVolume(playerId, settings.communication.voiceVolume);
+        this->updateProximityVolume(playerId);
+    } catch(const std::exception& e) {
+        ErrorQueues::get().debugWarn(std::string("Failed to create a voice stream: ") + e.what());
+    }
+#endif // GLOBED_VOICE_SUPPORT
+}
+
 void GlobedGJBGL::updateProximityVolume(int playerId) {
     if (m_fields->deafened || !m_fields->isVoiceProximity) return;
 
@@ -1044,6 +1050,27 @@ void GlobedGJBGL::handlePlayerLeave(int playerId) {
     m_fields->playerStore->removePlayer(playerId);
 }
 
+void GlobedGJBGL::handleLevelData(const std::vector<AssociatedPlayerData>& players) {
+    auto& fields = this->getFields();
+
+    fields.lastServerUpdate = fields.timeCounter;
+
+    for (const auto& player : players) {
+        this->handlePlayerData(player.accountId, player.data);
+    }
+}
+
+void GlobedGJBGL::handlePlayerData(int playerId, const PlayerData& data) {
+    auto& fields = this->getFields();
+
+    if (!fields.players.contains(playerId)) {
+        // new player joined
+        this->handlePlayerJoin(playerId);
+    }
+
+    fields.interpolator->updatePlayer(playerId, data, fields.lastServerUpdate);
+}
+
 bool GlobedGJBGL::established() {
     // the 2nd check is in case we disconnect while being in a level somehow
     return m_fields->globedReady && NetworkManager::get().established();
@@ -1099,6 +1126,9 @@ void GlobedGJBGL::onQuitActions() {
             nm.send(LevelLeavePacket::create());
         }
 
+        // the sequenced stream ends with the level, outside of it the loss comes from pings again
+        nm.resetLevelDataWindow();
+
 #ifdef GLOBED_VOICE_SUPPORT
         // stop voice recording and playback
         GlobedAudioManager::get().haltRecording();
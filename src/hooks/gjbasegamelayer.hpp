@@ -136,9 +136,14 @@ struct GLOBED_DLL GlobedGJBGL : geode::Modify<GlobedGJBGL, GJBaseGameLayer> {
 
     bool shouldLetMessageThrough(int playerId);
     void updateProximityVolume(int playerId);
+    // called for every voice packet, creates the stream of the player (or removes it if they should not be heard) and sets its volume
+    void handleVoiceFrame(int playerId);
 
     void handlePlayerJoin(int playerId);
     void handlePlayerLeave(int playerId);
+    void handlePlayerData(int playerId, const PlayerData& data);
+    // called for every `LevelDataPacket` and `SequencedLevelDataPacket`
+    void handleLevelData(const std::vector<AssociatedPlayerData>& players);
 
     /* misc */
 
@@ -23,13 +23,18 @@ Result<bool> GameServerManager::addOrUpdateServer(const std::string_view serverI
 
     int ping = -1;
     uint16_t playerCount = 0;
+    PingStats pingStats;
+    util::collections::CappedQueue<int, PING_WINDOW> pingWindow;
 
     auto data = _data.lock();
     if (data->servers.contains(serverId)) {
-        auto& server = data->servers.at(serverId).server;
+        auto& gsdata = data->servers.at(serverId);
+        auto& server = gsdata.server;
 
         ping = server.ping;
         playerCount = server.playerCount;
+        pingStats = server.pingStats;
+        pingWindow = gsdata.pingWindow;
 
         // check if the server changed
         if (
@@ -49,10 +54,12 @@ Result<bool> GameServerManager::addOrUpdateServer(const std::string_view serverI
         .address = std::string(address),
         .ping = ping,
         .playerCount = playerCount,
+        .pingStats = pingStats,
     };
 
     GameServerManager::GameServerData gsdata = {
-        .server = server
+        .server = server,
+        .pingWindow = std::move(pingWindow),
     };
 
     data->servers[serverId] = gsdata;
@@ -225,12 +232,14 @@ uint32_t GameServerManager::startPing(const std::string_view serverId) {
     auto data = _data.lock();
     auto& gsdata = data->servers.at(std::string(serverId));
 
+    auto now = util::time::now();
+    gsdata.expirePings(now);
+
     if (gsdata.pendingPings.size() > 50) {
         log::warn("over 50 pending pings for the game server {}, clearing", serverId);
-        gsdata.pendingPings.clear();
+        gsdata.dropPendingPings();
     }
 
-    auto now = util::time::now();
     gsdata.pendingPings[pingId] = now;
 
     return pingId;
@@ -249,11 +258,22 @@ void GameServerManager::finishPing(uint32_t pingId, uint32_t playerCount) {
             server.server.ping = timeTook;
             server.server.playerCount = playerCount;
             server.pendingPings.erase(pingId);
+            server.pushPingResult(timeTook);
             return;
         }
     }
 }
 
+void GameServerManager::expirePings() {
+    auto now = util::time::now();
+
+    auto data = _data.lock();
+
+    for (auto& [_, server] : data->servers) {
+        server.expirePings(now);
+    }
+}
+
 void GameServerManager::startKeepalive() {
     std::string active = _data.lock()->active;
 
@@ -267,3 +287,84 @@ void GameServerManager::finishKeepalive(uint32_t playerCount) {
     uint32_t activePingId = _data.lock()->activePingId;
     this->finishPing(activePingId, playerCount);
 }
+
+static PingStats computePingStats(const std::vector<int>& window) {
+    PingStats stats;
+    if (window.empty()) return stats;
+
+    std::vector<int> pings;
+    pings.reserve(window.size());
+
+    size_t lost = 0;
+    int64_t jitterSum = 0;
+    int prev = -1;
+
+    for (int ping : window) {
+        if (ping < 0) {
+            lost++;
+            continue;
+        }
+
+        if (prev != -1) {
+            jitterSum += std::abs(ping - prev);
+        }
+
+        prev = ping;
+        pings.push_back(ping);
+    }
+
+    stats.loss = static_cast<float>(lost) / window.size();
+
+    if (pings.empty()) return stats;
+
+    std::sort(pings.begin(), pings.end());
+
+    int64_t sum = 0;
+    for (int ping : pings) {
+        sum += ping;
+    }
+
+    // nearest-rank percentile
+    size_t p95Rank = (pings.size() * 95 + 99) / 100;
+
+    stats.min = pings.front();
+    stats.avg = sum / pings.size();
+    stats.p95 = pings[p95Rank - 1];
+    stats.jitter = pings.size() > 1 ? jitterSum / (pings.size() - 1) : 0;
+
+    return stats;
+}
+
+void GameServerManager::GameServerData::pushPingResult(int ping) {
+    pingWindow.push(std::move(ping));
+    server.pingStats = computePingStats(pingWindow.extract());
+}
+
+void GameServerManager::GameServerData::expirePings(util::time::time_point now) {
+    bool changed = false;
+
+    for (auto it = pendingPings.begin(); it != pendingPings.end();) {
+        if (now - it->second > PING_TIMEOUT) {
+            pingWindow.push(-1);
+            it = pendingPings.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (changed) {
+        server.pingStats = computePingStats(pingWindow.extract());
+    }
+}
+
+void GameServerManager::GameServerData::dropPendingPings() {
+    if (pendingPings.empty()) return;
+
+    for (size_t i = 0; i < pendingPings.size(); i++) {
+        pingWindow.push(-1);
+    }
+
+    pendingPings.clear();
+    server.pingStats = computePingStats(pingWindow.extract());
+}
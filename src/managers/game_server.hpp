@@ -4,18 +4,29 @@
 #include <unordered_map>
 #include <asp/sync.hpp> // mutex
 
+#include <util/collections.hpp>
 #include <util/crypto.hpp> // base64
 #include <util/time.hpp>
 #include <util/singleton.hpp>
 
+// Statistics over the most recent pings of a server. Times are in milliseconds, -1 until a ping succeeds.
+struct PingStats {
+    int min = -1;
+    int avg = -1;
+    int p95 = -1;
+    int jitter = -1; // average difference between two consecutive pings
+    float loss = 0.f; // fraction of pings that got no response, from 0 to 1
+};
+
 struct GameServer {
     std::string id;
     std::string name;
     std::string region;
     std::string address;
 
-    int ping;
+    int ping; // latest ping
     uint32_t playerCount;
+    PingStats pingStats;
 };
 
 // This class is fully thread safe to use.
@@ -30,6 +41,11 @@ public:
     constexpr static const char* LAST_CONNECTED_SETTING_KEY = "_last-connected-addr";
     constexpr static const char* SERVER_RESPONSE_CACHE_KEY = "_last-cached-servers-response";
 
+    // how many of the latest pings `PingStats` are computed from
+    constexpr static size_t PING_WINDOW = 20;
+    // a ping without a response after this long is counted as lost
+    constexpr static auto PING_TIMEOUT = util::time::seconds(3);
+
     asp::AtomicBool pendingChanges;
 
     // Returns true if a new server has been added, otherwise false.
@@ -69,6 +85,9 @@ public:
     uint32_t startPing(const std::string_view serverId);
     void finishPing(uint32_t pingId, uint32_t playerCount);
 
+    // count pings that got no response within `PING_TIMEOUT` as lost, on every server
+    void expirePings();
+
     void startKeepalive();
     void finishKeepalive(uint32_t playerCount);
 
@@ -77,6 +96,13 @@ protected:
     struct GameServerData {
         GameServer server;
         std::unordered_map<uint32_t, util::time::time_point> pendingPings;
+        // latest ping results in milliseconds, -1 for lost pings
+        util::collections::CappedQueue<int, PING_WINDOW> pingWindow;
+
+        void pushPingResult(int ping);
+        void expirePings(util::time::time_point now);
+        // counts every pending ping as lost and forgets about them
+        void dropPendingPings();
     };
 
     struct InnerData {
@@ -170,6 +170,7 @@ public:
         LimitedSetting<float, 0.3f, 0.f, 1.f> opacity;
         Setting<bool, true> hideConditionally;
         LimitedSetting<int, 3, 0, 3> position; // 0-3 topleft, topright, bottomleft, bottomright
+        Setting<bool, false> networkStats;
     };
 
     struct Communication {
@@ -182,6 +183,9 @@ public:
         Setting<int, 0> audioDevice;
         Setting<bool, true> deafenNotification;
         Setting<bool, false> voiceLoopback; // TODO unimpl
+        Setting<bool, false> voiceMixer;
+        Setting<bool, true> silenceSuppression;
+        LimitedSetting<float, 0.4f, 0.f, 2.f> silenceHangover;
     };
 
     struct LevelUI {
@@ -296,11 +300,11 @@ GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Globed, (
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Overlay, (
-    enabled, opacity, hideConditionally, position
+    enabled, opacity, hideConditionally, position, networkStats
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::Communication, (
-    voiceEnabled, voiceProximity, classicProximity, voiceVolume, onlyFriends, lowerAudioLatency, audioDevice, deafenNotification, voiceLoopback
+    voiceEnabled, voiceProximity, classicProximity, voiceVolume, onlyFriends, lowerAudioLatency, audioDevice, deafenNotification, voiceLoopback, voiceMixer, silenceSuppression, silenceHangover
 ));
 
 GLOBED_SERIALIZABLE_STRUCT(GlobedSettings::LevelUI, (
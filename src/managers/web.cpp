@@ -57,7 +57,7 @@ RequestTask WebRequestManager::requestAuthToken() {
 
         req.bodyJSON(obj);
         req.encrypted(true);
-        req.param("protocol", NetworkManager::get().getUsedProtocol());
+        req.param("protocol", NetworkManager::get().getCentralProtocol());
     });
 }
 
@@ -74,7 +74,7 @@ RequestTask WebRequestManager::challengeStart() {
 
         req.bodyJSON(accdata);
         req.encrypted(true);
-        req.param("protocol", NetworkManager::get().getUsedProtocol());
+        req.param("protocol", NetworkManager::get().getCentralProtocol());
     });
 }
 
@@ -108,7 +108,7 @@ RequestTask WebRequestManager::fetchCredits() {
 
 RequestTask WebRequestManager::fetchServers() {
     return this->get(makeCentralUrl("servers"), 10, [&](CurlRequest& req) {
-        req.param("protocol", NetworkManager::get().getUsedProtocol());
+        req.param("protocol", NetworkManager::get().getCentralProtocol());
     });
 }
 
@@ -6,9 +6,29 @@
 # include <netinet/in.h>
 #endif
 
+#include <asp/thread.hpp>
 #include <util/format.hpp>
 #include <util/net.hpp>
 
+constexpr size_t RESOLVER_THREADS = 4;
+
+// Created on the first async lookup. Being a function-local static, it is destroyed (and its threads joined)
+// before any singleton that was created earlier and could be referenced by the callbacks.
+static asp::ThreadPool& resolverPool() {
+    static asp::ThreadPool pool(RESOLVER_THREADS);
+    return pool;
+}
+
+void NetworkAddress::setDnsCacheTtl(util::time::seconds ttl, util::time::seconds negativeTtl) {
+    // a zero TTL would make `isResolveCached` never return true, and anything waiting on it would retry forever
+    dnsCacheTtl = std::max<util::time::seconds::rep>(ttl.count(), 1);
+    dnsNegativeCacheTtl = std::max<util::time::seconds::rep>(negativeTtl.count(), 1);
+}
+
+void NetworkAddress::clearDnsCache() {
+    dnsCache.lock()->clear();
+}
+
 NetworkAddress::NetworkAddress() {
     this->set("", DEFAULT_PORT);
 }
@@ -22,8 +42,20 @@ NetworkAddress::NetworkAddress(const std::string_view host, uint16_t port) {
 }
 
 void NetworkAddress::set(const std::string_view address) {
+    // [ipv6]:port or [ipv6]
+    if (address.starts_with('[')) {
+        auto bracket = address.find(']');
+        if (bracket != std::string::npos) {
+            auto rest = address.substr(bracket + 1);
+            uint16_t port = rest.starts_with(':') ? util::format::parse<uint16_t>(rest.substr(1)).value_or(DEFAULT_PORT) : DEFAULT_PORT;
+            this->set(address.substr(1, bracket - 1), port);
+            return;
+        }
+    }
+
     auto colon = address.find(':');
-    if (colon == std::string::npos) {
+    if (colon == std::string::npos || address.find(':', colon + 1) != std::string::npos) {
+        // no port, or a bare IPv6 address
         this->set(address, DEFAULT_PORT);
     } else {
         uint16_t port = util::format::parse<uint16_t>(address.substr(colon + 1)).value_or(DEFAULT_PORT);
@@ -37,50 +69,102 @@ void NetworkAddress::set(const std::string_view host, uint16_t port) {
 }
 
 std::string NetworkAddress::toString() const {
+    if (host.find(':') != std::string::npos) {
+        return "[" + host + "]:" + std::to_string(port);
+    }
+
     return host + ":" + std::to_string(port);
 }
 
-Result<sockaddr_in> NetworkAddress::resolve() const {
+Result<sockaddr_storage> NetworkAddress::resolve() const {
+    GLOBED_UNWRAP_INTO(this->resolveAll(), auto addresses);
+
+    return Ok(addresses.front());
+}
+
+Result<std::vector<sockaddr_storage>> NetworkAddress::resolveAll() const {
     if (host.empty()) {
         return Err("empty IP address or domain name, cannot resolve");
     }
 
-    // if it's cached then just use our cache
-    if (dnsCache.contains(host)) {
-        sockaddr_in out;
-        out.sin_family = AF_INET;
-        out.sin_port = util::net::hostToNetworkPort(port);
-        out.sin_addr = dnsCache.at(host);
-        return Ok(out);
+    std::vector<sockaddr_storage> addresses;
+
+    // IP addresses are parsed every time, only domain names go through the cache
+    sockaddr_storage literal;
+    if (util::net::stringToSockaddr(host.c_str(), literal)) {
+        addresses.push_back(literal);
+    } else {
+        auto now = util::time::now();
+        std::optional<DnsCacheEntry> cached;
+
+        {
+            auto cache = dnsCache.lock();
+            auto it = cache->find(host);
+            if (it != cache->end() && now < it->second.expiresAt) {
+                cached = it->second;
+            }
+        }
+
+        if (cached && cached->addresses.empty()) {
+            return Err(cached->error);
+        } else if (cached) {
+            addresses = std::move(cached->addresses);
+        } else {
+            auto result = util::net::getaddrinfo(host, addresses);
+
+            DnsCacheEntry entry;
+            if (result) {
+                entry.addresses = addresses;
+                entry.expiresAt = now + util::time::seconds(dnsCacheTtl.load());
+            } else {
+                entry.error = result.unwrapErr();
+                entry.expiresAt = now + util::time::seconds(dnsNegativeCacheTtl.load());
+            }
+
+            dnsCache.lock()->insert_or_assign(host, entry);
+
+            GLOBED_UNWRAP(std::move(result));
+        }
+    }
+
+    for (auto& addr : addresses) {
+        util::net::setSockaddrPort(addr, port);
     }
 
-    // for some reason this must be heap allocated or windows complains
-    auto addr = std::make_unique<sockaddr_in>();
-    addr->sin_family = AF_INET;
+    return Ok(std::move(addresses));
+}
+
+void NetworkAddress::resolveAsync(ResolveCallback&& callback) const {
+    if (this->isResolveCached()) {
+        callback(this->resolve());
+        return;
+    }
 
-    auto ipResult = util::net::stringToInAddr(host.c_str(), addr->sin_addr);
+    resolverPool().pushTask([address = *this, callback = std::move(callback)] {
+        callback(address.resolve());
+    });
+}
 
-    // if this is not a valid IP address, try getaddrinfo
-    if (!ipResult) {
-        GLOBED_UNWRAP(util::net::getaddrinfo(host, *addr));
+bool NetworkAddress::isResolveCached() const {
+    sockaddr_storage tmp;
+    if (host.empty() || util::net::stringToSockaddr(host.c_str(), tmp)) {
+        return true;
     }
 
-    // add to cache
-    dnsCache.emplace(std::make_pair(host, addr->sin_addr));
+    auto cache = dnsCache.lock();
+    auto it = cache->find(host);
 
-    sockaddr_in copy;
-    std::memcpy(&copy, addr.get(), sizeof(sockaddr_in));
-    copy.sin_family = AF_INET;
-    copy.sin_port = util::net::hostToNetworkPort(port);
-    return Ok(copy);
+    return it != cache->end() && util::time::now() < it->second.expiresAt;
 }
 
 Result<std::string> NetworkAddress::resolveToString() const {
-    // resolve to a sockaddr_in first
     GLOBED_UNWRAP_INTO(this->resolve(), auto addr);
 
-    // convert to string
-    GLOBED_UNWRAP_INTO(util::net::inAddrToString(addr.sin_addr), auto ipstr);
+    GLOBED_UNWRAP_INTO(util::net::sockaddrToString(addr), auto ipstr);
+
+    if (addr.ss_family == AF_INET6) {
+        return Ok("[" + ipstr + "]:" + std::to_string(port));
+    }
 
     return Ok(std::move(ipstr + ":" + std::to_string(port)));
 }
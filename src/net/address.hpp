@@ -1,27 +1,52 @@
 #pragma once
 #include <defs/minimal_geode.hpp>
 
+#include <functional>
 #include <string_view>
 #include <string>
+#include <vector>
+#include <asp/sync.hpp>
 
-// for sockaddr_in
+#include <util/time.hpp>
+
+// for sockaddr_storage
 #ifdef GEODE_IS_WINDOWS
 # include <WinSock2.h>
 #else
+# include <sys/socket.h>
 # include <netinet/in.h>
 #endif
 
 
-// Represents an IPv4 address and a port
+// Represents a host (domain name, IPv4 or IPv6 address) and a port
 class NetworkAddress {
-    static inline std::unordered_map<std::string, in_addr> dnsCache;
+    // A cached DNS lookup, without ports. If the lookup failed, `addresses` is empty and `error` holds the reason.
+    struct DnsCacheEntry {
+        std::vector<sockaddr_storage> addresses;
+        std::string error;
+        util::time::time_point expiresAt;
+    };
+
+    // locked because addresses get resolved from multiple threads at once
+    static inline asp::Mutex<std::unordered_map<std::string, DnsCacheEntry>> dnsCache;
+
+    static inline std::atomic<util::time::seconds::rep> dnsCacheTtl = 300;
+    static inline std::atomic<util::time::seconds::rep> dnsNegativeCacheTtl = 30;
 
 public:
     static constexpr uint16_t DEFAULT_PORT = 4202;
 
+    using ResolveCallback = std::function<void(geode::Result<sockaddr_storage>)>;
+
+    // Set for how long successful and failed DNS lookups are cached. Defaults to 5 minutes and 30 seconds.
+    static void setDnsCacheTtl(util::time::seconds ttl, util::time::seconds negativeTtl);
+
+    // Remove all cached DNS lookups
+    static void clearDnsCache();
+
     NetworkAddress();
 
-    // Parses the given string in format `host:port`
+    // Parses the given string in format `host:port`. IPv6 addresses must be in brackets if there is a port (`[::1]:4202`).
     NetworkAddress(const std::string_view address);
 
     // Constructs a `NetworkAddress` from the given host and port
@@ -36,9 +61,19 @@ public:
     // Returns the input in format `host:port`. If the host is a domain name, it is not resolved to an IP address.
     std::string toString() const;
 
-    // Returns a `sockaddr_in` struct corresponding to this `NetworkAddress`.
-    // Note that this might block for DNS lookup if contained host was not an IP address.
-    geode::Result<sockaddr_in> resolve() const;
+    // Returns the most preferred IPv4 or IPv6 address of this `NetworkAddress`.
+    // Note that this might block for DNS lookup if contained host was not an IP address and is not cached.
+    geode::Result<sockaddr_storage> resolve() const;
+
+    // Returns all IPv4 and IPv6 addresses of this `NetworkAddress`, most preferred first. Blocks just like `resolve`.
+    geode::Result<std::vector<sockaddr_storage>> resolveAll() const;
+
+    // Like `resolve`, but never blocks. If the result is cached, `callback` is called right away,
+    // otherwise the lookup runs on a resolver thread and `callback` is called on that thread.
+    void resolveAsync(ResolveCallback&& callback) const;
+
+    // Returns whether `resolve` would return without blocking
+    bool isResolveCached() const;
 
     // Combination of `resolve` and `toString`, returns the input in format `host:port` but does do DNS resolution.
     // Note that this might block for DNS lookup if contained host was not an IP address.
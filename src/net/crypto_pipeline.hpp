@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <asp/thread.hpp>
+
+// Runs the crypto for a batch of packets on a few worker threads, while the calling thread handles the finished packets in order.
+// This lets a burst of encrypted packets (mostly voice) get decrypted in parallel, with decoding overlapping the decryption of later packets.
+class CryptoPipeline {
+public:
+    explicit CryptoPipeline(size_t workers) : pool(workers), workers(workers) {}
+
+    CryptoPipeline(const CryptoPipeline&) = delete;
+    CryptoPipeline& operator=(const CryptoPipeline&) = delete;
+
+    size_t workerCount() const {
+        return workers;
+    }
+
+    // Calls `work(i)` for every `i` in `[0, count)`, spread across the workers and the calling thread,
+    // and `complete(i)` on the calling thread in ascending order, as soon as `work(i)` has finished.
+    // `work` must be safe to call from multiple threads at once. Returns once everything is completed.
+    template <typename WorkF, typename CompleteF>
+    void run(size_t count, WorkF&& work, CompleteF&& complete) {
+        if (count == 0) return;
+
+        auto done = std::make_unique<std::atomic<bool>[]>(count);
+        std::atomic<size_t> next = 0;
+
+        auto claimOne = [&] {
+            size_t i = next.fetch_add(1, std::memory_order::relaxed);
+            if (i >= count) return false;
+
+            work(i);
+            done[i].store(true, std::memory_order::release);
+            return true;
+        };
+
+        size_t helpers = std::min(workers, count - 1);
+        for (size_t i = 0; i < helpers; i++) {
+            pool.pushTask([&] {
+                while (claimOne()) {}
+            });
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            // rather than idly waiting for a worker to finish this one, take care of a later one
+            while (!done[i].load(std::memory_order::acquire)) {
+                if (!claimOne()) {
+                    std::this_thread::yield();
+                }
+            }
+
+            complete(i);
+        }
+
+        // the workers still reference this stack frame until they notice there is nothing left
+        pool.join();
+    }
+
+private:
+    asp::ThreadPool pool;
+    size_t workers;
+};
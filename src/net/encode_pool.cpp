@@ -0,0 +1,67 @@
+#include "encode_pool.hpp"
+
+#include <unordered_map>
+
+namespace {
+    struct ThreadPoolState {
+        std::vector<ByteBuffer> buffers;
+        std::unordered_map<packetid_t, size_t> sizeHints;
+    };
+
+    thread_local ThreadPoolState poolState;
+}
+
+EncodeBufferPool::Handle::Handle(packetid_t id, size_t initialCapacity, ByteBuffer&& buffer)
+    : id(id), initialCapacity(initialCapacity), buffer(std::move(buffer)) {}
+
+EncodeBufferPool::Handle::~Handle() {
+    EncodeBufferPool::release(*this);
+}
+
+EncodeBufferPool::Handle EncodeBufferPool::acquire(packetid_t id) {
+    auto& state = poolState;
+
+    ByteBuffer buffer;
+    if (!state.buffers.empty()) {
+        buffer = std::move(state.buffers.back());
+        state.buffers.pop_back();
+    }
+
+    // capacity before reserving, so that reserving more memory counts as a miss
+    size_t capacity = buffer.capacity();
+
+    auto hint = state.sizeHints.find(id);
+    if (hint != state.sizeHints.end()) {
+        buffer.reserve(hint->second);
+    }
+
+    return Handle(id, capacity, std::move(buffer));
+}
+
+EncodeBufferPool::Stats EncodeBufferPool::getStats() {
+    return Stats {
+        .hits = hits.load(std::memory_order::relaxed),
+        .misses = misses.load(std::memory_order::relaxed),
+    };
+}
+
+void EncodeBufferPool::release(Handle& handle) {
+    auto& state = poolState;
+    size_t size = handle.buffer.size();
+
+    if (size <= handle.initialCapacity) {
+        hits.fetch_add(1, std::memory_order::relaxed);
+    } else {
+        misses.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    auto& hint = state.sizeHints[handle.id];
+    hint = std::max(hint, size);
+
+    if (handle.buffer.capacity() > MAX_RETAINED_CAPACITY || state.buffers.size() >= MAX_POOLED_BUFFERS) {
+        return;
+    }
+
+    handle.buffer.clear();
+    state.buffers.push_back(std::move(handle.buffer));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+
+#include <data/bytebuffer.hpp>
+#include <data/packets/packet.hpp>
+
+// Pool of reusable buffers for encoding outgoing packets.
+// Every thread has its own set of buffers, so no locking is involved. Buffers keep their capacity when returned,
+// and get reserved upfront based on the largest encoded size seen for the packet ID, so steady state sending does not allocate.
+class GLOBED_DLL EncodeBufferPool {
+public:
+    struct Stats {
+        size_t hits;   // the buffer already had enough capacity for the packet
+        size_t misses; // the buffer had to allocate
+    };
+
+    // Gives access to a pooled buffer, and puts it back into the pool once destroyed.
+    class Handle {
+    public:
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        Handle(Handle&&) = delete;
+        Handle& operator=(Handle&&) = delete;
+
+        ~Handle();
+
+        ByteBuffer& operator*() {
+            return buffer;
+        }
+
+        ByteBuffer* operator->() {
+            return &buffer;
+        }
+
+    private:
+        friend class EncodeBufferPool;
+
+        Handle(packetid_t id, size_t initialCapacity, ByteBuffer&& buffer);
+
+        packetid_t id;
+        size_t initialCapacity;
+        ByteBuffer buffer;
+    };
+
+    // Take an empty buffer from the pool of the calling thread, reserved for a packet with the given ID.
+    static Handle acquire(packetid_t id);
+
+    static Stats getStats();
+
+private:
+    // buffers that grew larger than this get freed instead of being kept around
+    static constexpr size_t MAX_RETAINED_CAPACITY = 1 << 16;
+    // max amount of buffers kept per thread
+    static constexpr size_t MAX_POOLED_BUFFERS = 4;
+
+    static inline std::atomic<size_t> hits = 0;
+    static inline std::atomic<size_t> misses = 0;
+
+    static void release(Handle& handle);
+};
@@ -1,4 +1,5 @@
 #include "game_socket.hpp"
+#include "encode_pool.hpp"
 
 #include <data/bytebuffer.hpp>
 #include <data/packets/match.hpp>
@@ -21,6 +22,20 @@ using namespace util::debug;
 using PollResult = GameSocket::PollResult;
 using ReceivedPacket = GameSocket::ReceivedPacket;
 
+// Runs `work` and then `complete` for every packet, on the crypto workers if there are any and more than one packet
+template <typename WorkF, typename CompleteF>
+static void runCryptoStage(CryptoPipeline* pipeline, size_t count, WorkF&& work, CompleteF&& complete) {
+    if (pipeline && count > 1) {
+        pipeline->run(count, work, complete);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        work(i);
+        complete(i);
+    }
+}
+
 GameSocket::GameSocket() {
     dataBuffer = new byte[DATA_BUF_SIZE];
 }
@@ -29,7 +44,7 @@ GameSocket::~GameSocket() {
     delete[] dataBuffer;
 }
 
-Result<> GameSocket::connect(const NetworkAddress& address, bool isRecovering) {
+Result<> GameSocket::connect(const NetworkAddress& address, std::shared_ptr<Packet> initialPacket) {
 #ifdef GLOBED_DEBUG
     auto r = address.resolveToString();
     std::string resolved = "<unresolved>";
@@ -42,12 +57,52 @@ Result<> GameSocket::connect(const NetworkAddress& address, bool isRecovering) {
     log::debug("Connecting to {} (resolved to {})", address.toString(), resolved);
 #endif
 
+    // batching is enabled again once we know the server supports it
+    this->setUdpBatching(false, 0);
+    pendingUdpPackets.clear();
+    tcpRecvStart = tcpRecvEnd = 0;
+
     GLOBED_UNWRAP(tcpSocket.connect(address))
-    GLOBED_UNWRAP(udpSocket.connect(address))
+    // use the same address the tcp connection ended up on, so both go over the same IP family
+    GLOBED_UNWRAP(udpSocket.connect(tcpSocket.destination()))
 
-    // send a magic byte telling the server whether we are recovering or not
-    uint8_t byte = isRecovering ? MARKER_CONN_RECOVERY : MARKER_CONN_INITIAL;
-    GLOBED_UNWRAP(tcpSocket.send(reinterpret_cast<const char*>(&byte), 1));
+    // send a magic byte telling the server this is a new connection, followed by the initial packet
+    ByteBuffer buf;
+    buf.writeU8(MARKER_CONN_INITIAL);
+
+    if (initialPacket) {
+        GLOBED_REQUIRE_SAFE(initialPacket->getUseTcp(), "the initial packet must be a TCP packet")
+        GLOBED_UNWRAP(this->encodePacket(*initialPacket, buf))
+
+        if (dumpPackets) {
+            auto packetBuf = ByteBuffer::view(buf.dataPtr() + 1, buf.size() - 1);
+            this->dumpPacket(initialPacket->getPacketId(), packetBuf, true);
+        }
+    }
+
+    GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.dataPtr()), buf.size()));
+
+    return Ok();
+}
+
+Result<> GameSocket::resume(const NetworkAddress& address, int accountId, uint32_t secretKey) {
+    // the server keeps using the keys from the original handshake
+    GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "cannot resume a session without a cryptobox")
+
+    GLOBED_UNWRAP(tcpSocket.connect(address))
+    // a frame cut off by the dropped connection is never going to be completed
+    tcpRecvStart = tcpRecvEnd = 0;
+
+    // only updates the destination, the socket and its local port stay the same
+    GLOBED_UNWRAP(udpSocket.connect(tcpSocket.destination()))
+
+    // the marker and the session to resume go out in a single write
+    ByteBuffer buf;
+    buf.writeU8(MARKER_CONN_RECOVERY);
+    buf.writeI32(accountId);
+    buf.writeU32(secretKey);
+
+    GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.dataPtr()), buf.size()));
 
     return Ok();
 }
@@ -62,37 +117,185 @@ bool GameSocket::isConnected() {
 }
 
 Result<std::shared_ptr<Packet>> GameSocket::recvPacketTCP() {
-    ByteBuffer bb;
-    bb.grow(4);
+    // with a whole frame buffered the socket might have nothing to read, and reading would block
+    GLOBED_UNWRAP_INTO(this->bufferedTcpFrame(), auto frameSize);
+
+    if (!frameSize) {
+        // move the incomplete frame to the front, so it can be completed in place
+        if (tcpRecvStart != 0) {
+            std::memmove(dataBuffer, dataBuffer + tcpRecvStart, tcpRecvEnd - tcpRecvStart);
+            tcpRecvEnd -= tcpRecvStart;
+            tcpRecvStart = 0;
+        }
 
-    // receive the packet length
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(bb.data().data()), 4));
+        int result = tcpSocket.receive(reinterpret_cast<char*>(dataBuffer + tcpRecvEnd), DATA_BUF_SIZE - tcpRecvEnd).result;
+        if (result < 0) return Err(util::net::lastErrorString());
+        if (result == 0) return Err("connection was closed by the server");
 
-    auto packetSize = bb.readU32().value_or(0); // must always be 4 bytes so cant error
-    GLOBED_REQUIRE_SAFE(packetSize < DATA_BUF_SIZE, "packet is too big, rejecting")
+        tcpRecvEnd += result;
 
-    GLOBED_UNWRAP(tcpSocket.recvExact(reinterpret_cast<char*>(dataBuffer), packetSize));
+        GLOBED_UNWRAP_INTO(this->bufferedTcpFrame(), frameSize);
+        if (!frameSize) {
+            return Ok(std::shared_ptr<Packet>());
+        }
+    }
+
+    // decode straight out of the receive buffer, the packet must not keep any references to it
+    auto buf = ByteBuffer::view(dataBuffer + tcpRecvStart + sizeof(uint32_t), *frameSize - sizeof(uint32_t));
+    tcpRecvStart += *frameSize;
 
-    ByteBuffer buf(dataBuffer, packetSize);
+    if (tcpRecvStart == tcpRecvEnd) {
+        tcpRecvStart = tcpRecvEnd = 0;
+    }
 
     return this->decodePacket(buf);
 }
 
+bool GameSocket::hasPendingTCP() {
+    auto frame = this->bufferedTcpFrame();
+    return frame.isOk() && frame.unwrap().has_value();
+}
+
+Result<std::optional<size_t>> GameSocket::bufferedTcpFrame() {
+    size_t buffered = tcpRecvEnd - tcpRecvStart;
+    if (buffered < sizeof(uint32_t)) {
+        return Ok(std::nullopt);
+    }
+
+    auto bb = ByteBuffer::view(dataBuffer + tcpRecvStart, sizeof(uint32_t));
+    auto packetSize = bb.readU32().value_or(0); // must always be 4 bytes so cant error
+    GLOBED_REQUIRE_SAFE(packetSize < DATA_BUF_SIZE - sizeof(uint32_t), "packet is too big, rejecting")
+
+    size_t frameSize = sizeof(uint32_t) + packetSize;
+    return Ok(buffered >= frameSize ? std::optional(frameSize) : std::nullopt);
+}
+
 Result<ReceivedPacket> GameSocket::recvPacketUDP() {
-    auto recvResult = udpSocket.receive(reinterpret_cast<char*>(dataBuffer), DATA_BUF_SIZE);
+    if (!pendingUdpPackets.empty()) {
+        auto packet = std::move(pendingUdpPackets.front());
+        pendingUdpPackets.pop_front();
+        return Ok(std::move(packet));
+    }
+
+    // receive everything that is ready in one go
+    if (auto res = udpSocket.receiveMany(udpRecvBatch); !res) {
+        return Err(fmt::format("udp recv failed: {}", res.unwrapErr()));
+    }
+
+    // if a datagram is invalid, still keep the packets from the other ones, they are returned by the next calls
+    std::optional<std::string> error;
+    incomingUdp.clear();
+
+    for (size_t i = 0; i < udpRecvBatch.size(); i++) {
+        auto& dgram = udpRecvBatch[i];
+        auto buf = ByteBuffer::view(dgram.data, dgram.size);
+
+        auto result = this->splitDatagram(buf, dgram.fromServer);
+        if (!result && !error) {
+            error = std::move(result.unwrapErr());
+        }
+    }
+
+    this->decodeIncoming(error);
+
+    if (error) {
+        return Err(std::move(*error));
+    }
+
+    GLOBED_REQUIRE_SAFE(!pendingUdpPackets.empty(), "received an empty batched packet")
+
+    return this->recvPacketUDP();
+}
 
-    ReceivedPacket out;
-    out.fromConnected = recvResult.fromServer;
+Result<> GameSocket::splitDatagram(ByteBuffer& buffer, bool fromConnected) {
+    auto header = buffer.readValue<PacketHeader>();
+    GLOBED_REQUIRE_SAFE(header.isOk(), "udp packet is too short")
+    buffer.setPosition(0);
 
-    if (recvResult.result < 0) {
-        return Err("udp recv failed");
+    if (header.unwrap().id == BATCH_PACKET_ID) {
+        return this->unpackBatch(buffer, fromConnected);
     }
 
-    ByteBuffer buf(dataBuffer, (size_t)recvResult.result);
+    incomingUdp.push_back(IncomingPacket {
+        .buffer = buffer,
+        .fromConnected = fromConnected,
+        .encrypted = header.unwrap().encrypted,
+    });
 
-    GLOBED_UNWRAP_INTO(this->decodePacket(buf), out.packet);
+    return Ok();
+}
+
+void GameSocket::decodeIncoming(std::optional<std::string>& error) {
+    size_t encrypted = 0;
+    for (auto& incoming : incomingUdp) {
+        if (incoming.encrypted) encrypted++;
+    }
 
-    return Ok(std::move(out));
+    auto decrypt = [&](size_t i) {
+        auto& incoming = incomingUdp[i];
+        if (!incoming.encrypted) return;
+
+        auto result = this->decryptPacket(incoming.buffer);
+        if (result) {
+            incoming.plaintext = result.unwrap();
+        } else {
+            incoming.decryptError = std::move(result.unwrapErr());
+        }
+    };
+
+    auto decode = [&](size_t i) {
+        auto& incoming = incomingUdp[i];
+
+        if (incoming.decryptError) {
+            if (!error) error = std::move(*incoming.decryptError);
+            return;
+        }
+
+        auto result = this->decodePacket(incoming.buffer, incoming.encrypted ? &incoming.plaintext : nullptr);
+        if (!result) {
+            if (!error) error = std::move(result.unwrapErr());
+            return;
+        }
+
+        pendingUdpPackets.push_back(ReceivedPacket {
+            .packet = std::move(result.unwrap()),
+            .fromConnected = incoming.fromConnected,
+        });
+    };
+
+    // a lone encrypted packet is not worth handing off to another thread
+    runCryptoStage(encrypted > 1 ? cryptoPipeline.get() : nullptr, incomingUdp.size(), decrypt, decode);
+    incomingUdp.clear();
+}
+
+bool GameSocket::hasPendingUDP() {
+    return !pendingUdpPackets.empty();
+}
+
+Result<> GameSocket::unpackBatch(ByteBuffer& buffer, bool fromConnected) {
+    buffer.setPosition(PacketHeader::SIZE);
+
+    while (buffer.getPosition() < buffer.size()) {
+        auto length_ = buffer.readU16();
+        GLOBED_REQUIRE_SAFE(length_.isOk(), "batched packet is truncated")
+
+        size_t length = length_.unwrap();
+        size_t start = buffer.getPosition();
+        GLOBED_REQUIRE_SAFE(length >= PacketHeader::SIZE && length <= buffer.size() - start, "batched packet has an invalid length")
+
+        // each packet gets its own view, so decryption stays within its bounds
+        auto packetBuf = ByteBuffer::view(buffer.dataPtr() + start, length);
+        buffer.setPosition(start + length);
+
+        incomingUdp.push_back(IncomingPacket {
+            .buffer = packetBuf,
+            .fromConnected = fromConnected,
+            .encrypted = packetBuf.readValue<PacketHeader>().unwrap().encrypted,
+        });
+        incomingUdp.back().buffer.setPosition(0);
+    }
+
+    return Ok();
 }
 
 Result<ReceivedPacket> GameSocket::recvPacket(int timeoutMs) {
@@ -106,6 +309,7 @@ Result<ReceivedPacket> GameSocket::recvPacket(int timeoutMs) {
     // prioritize TCP, if the result is Tcp or Both, we care about TCP.
     if (pollResult != PollResult::Udp) {
         GLOBED_UNWRAP_INTO(this->recvPacketTCP(), auto packet);
+        GLOBED_REQUIRE_SAFE(packet != nullptr, "received a partial tcp packet, the rest has not arrived yet")
         return Ok(ReceivedPacket {
             .packet = std::move(packet),
             .fromConnected = true
@@ -121,50 +325,216 @@ Result<ReceivedPacket> GameSocket::recvPacket() {
 }
 
 Result<> GameSocket::sendPacket(std::shared_ptr<Packet> packet) {
-    GLOBED_REQUIRE_SAFE(this->isConnected(), "attempting to send a packet while disconnected")
+    GLOBED_REQUIRE_SAFE(packet->getUseTcp() ? tcpSocket.connected : udpSocket.connected, "attempting to send a packet while disconnected")
 
-    ByteBuffer buf;
-    GLOBED_UNWRAP(this->encodePacket(*packet, buf))
+    auto buf = EncodeBufferPool::acquire(packet->getPacketId());
+    GLOBED_UNWRAP(this->encodePacket(*packet, *buf))
 
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), *buf, true);
     }
 
     if (packet->getUseTcp()) {
-        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        GLOBED_UNWRAP(tcpSocket.sendAll(reinterpret_cast<const char*>(buf->dataPtr()), buf->size()));
     } else {
-        GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(buf.data().data()), buf.size()));
+        GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(buf->dataPtr()), buf->size()));
     }
 
     return Ok();
 }
 
+Result<> GameSocket::queuePacket(std::shared_ptr<Packet> packet) {
+    if (!udpBatching || packet->getUseTcp()) {
+        return this->sendPacket(std::move(packet));
+    }
+
+    GLOBED_REQUIRE_SAFE(packet->getUseTcp() ? tcpSocket.connected : udpSocket.connected, "attempting to send a packet while disconnected")
+
+    size_t packetSize = PacketHeader::SIZE + packet->encodedSize() + (packet->getEncrypted() ? CryptoBox::PREFIX_LEN : 0);
+
+    // too big to share a datagram with anything else
+    if (BATCH_OVERHEAD + packetSize > udpBatchLimit) {
+        GLOBED_UNWRAP(this->flushPackets());
+        return this->sendPacket(std::move(packet));
+    }
+
+    if (udpBatchCount > 0 && udpBatch.size() + sizeof(uint16_t) + packetSize > udpBatchLimit) {
+        GLOBED_UNWRAP(this->flushPackets());
+    }
+
+    if (udpBatchCount == 0) {
+        udpBatch.clear();
+        udpBatch.writeValue<PacketHeader>(PacketHeader {
+            .id = BATCH_PACKET_ID,
+            .encrypted = false,
+        });
+    }
+
+    // reserve space for the length, encode the packet and then go back to write it
+    size_t lengthPos = udpBatch.size();
+    udpBatch.writeU16(0);
+
+    // with crypto workers, encryption is left for `flushPackets` so that the whole batch gets encrypted at once
+    auto result = this->encodePacket(*packet, udpBatch, cryptoPipeline ? &udpBatchEncryption : nullptr);
+    if (!result) {
+        udpBatch.resize(lengthPos);
+        udpBatch.setPosition(lengthPos);
+        return result;
+    }
+
+    size_t endPos = udpBatch.size();
+    udpBatch.setPosition(lengthPos);
+    udpBatch.writeU16(endPos - lengthPos - sizeof(uint16_t));
+    udpBatch.setPosition(endPos);
+
+    udpBatchCount++;
+
+    if (dumpPackets) {
+        auto buf = ByteBuffer::view(udpBatch.dataPtr() + lengthPos + sizeof(uint16_t), endPos - lengthPos - sizeof(uint16_t));
+        this->dumpPacket(packet->getPacketId(), buf, true);
+    }
+
+    return Ok();
+}
+
+Result<> GameSocket::flushPackets() {
+    if (udpBatchCount == 0) {
+        return Ok();
+    }
+
+    size_t count = std::exchange(udpBatchCount, 0);
+
+    GLOBED_UNWRAP(this->encryptBatch());
+
+    const byte* data = udpBatch.dataPtr();
+    size_t size = udpBatch.size();
+
+    // a lone packet is sent as is, without the batch header
+    if (count == 1) {
+        data += BATCH_OVERHEAD;
+        size -= BATCH_OVERHEAD;
+    }
+
+    GLOBED_UNWRAP(udpSocket.send(reinterpret_cast<const char*>(data), size));
+
+    return Ok();
+}
+
+Result<> GameSocket::encryptBatch() {
+    if (udpBatchEncryption.empty()) {
+        return Ok();
+    }
+
+    GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to encrypt a packet when no cryptobox is initialized")
+
+    std::vector<std::optional<std::string>> errors(udpBatchEncryption.size());
+    std::optional<std::string> error;
+
+    runCryptoStage(cryptoPipeline.get(), udpBatchEncryption.size(), [&](size_t i) {
+        auto [offset, size] = udpBatchEncryption[i];
+        byte* data = udpBatch.dataPtr() + offset;
+
+        auto result = cryptoBox->encryptInto(data, data, size);
+        if (!result) {
+            errors[i] = std::move(result.unwrapErr());
+        }
+    }, [&](size_t i) {
+        if (errors[i] && !error) {
+            error = std::move(errors[i]);
+        }
+    });
+
+    udpBatchEncryption.clear();
+
+    if (error) {
+        return Err(std::move(*error));
+    }
+
+    return Ok();
+}
+
+void GameSocket::setUdpBatching(bool enabled, size_t limit) {
+    udpBatching = enabled;
+    udpBatchLimit = std::min(limit, BATCH_MTU);
+    udpBatchCount = 0;
+    udpBatchEncryption.clear();
+}
+
+void GameSocket::setCryptoWorkers(size_t workers) {
+    cryptoPipeline = workers == 0 ? nullptr : std::make_unique<CryptoPipeline>(workers);
+}
+
 Result<> GameSocket::sendPacketTo(std::shared_ptr<Packet> packet, const NetworkAddress& address) {
     GLOBED_REQUIRE_SAFE(!packet->getUseTcp(), "cannot send a TCP packet to a UDP connection")
 
-    ByteBuffer buf;
-    GLOBED_UNWRAP(this->encodePacket(*packet, buf))
+    auto buf = EncodeBufferPool::acquire(packet->getPacketId());
+    GLOBED_UNWRAP(this->encodePacket(*packet, *buf))
 
     if (dumpPackets) {
-        this->dumpPacket(packet->getPacketId(), buf, true);
+        this->dumpPacket(packet->getPacketId(), *buf, true);
     }
 
-    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf.data().data()), buf.size(), address), auto res)
+    GLOBED_UNWRAP_INTO(udpSocket.sendTo(reinterpret_cast<const char*>(buf->dataPtr()), buf->size(), address), auto res)
 
     GLOBED_REQUIRE_SAFE(
-        res == buf.size(),
+        res == buf->size(),
         "failed to send the entire buffer"
     )
 
     return Ok();
 }
 
-Result<> GameSocket::sendRecoveryData(int accountId, uint32_t secretKey) {
-    ByteBuffer bb;
-    bb.writeI32(accountId);
-    bb.writeU32(secretKey);
+Result<> GameSocket::sendPacketsTo(std::span<const std::pair<std::shared_ptr<Packet>, NetworkAddress>> packets) {
+    std::vector<sockaddr_storage> destinations;
+    std::vector<size_t> offsets;
+    destinations.reserve(packets.size());
+    offsets.reserve(packets.size() + 1);
+
+    // encode everything into one buffer, the datagrams point into it
+    ByteBuffer buf;
+    std::optional<std::string> error;
+
+    for (auto& [packet, address] : packets) {
+        GLOBED_REQUIRE_SAFE(!packet->getUseTcp(), "cannot send a TCP packet to a UDP connection")
+
+        auto dest = address.resolve();
+        if (!dest) {
+            if (!error) error = std::move(dest.unwrapErr());
+            continue;
+        }
+
+        offsets.push_back(buf.size());
+        GLOBED_UNWRAP(this->encodePacket(*packet, buf))
+        destinations.push_back(dest.unwrap());
+
+        if (dumpPackets) {
+            auto view = ByteBuffer::view(buf.dataPtr() + offsets.back(), buf.size() - offsets.back());
+            this->dumpPacket(packet->getPacketId(), view, true);
+        }
+    }
+
+    offsets.push_back(buf.size());
 
-    return tcpSocket.sendAll(reinterpret_cast<const char*>(bb.data().data()), bb.size());
+    std::vector<UdpSocket::OutgoingDatagram> datagrams;
+    datagrams.reserve(destinations.size());
+
+    for (size_t i = 0; i < destinations.size(); i++) {
+        datagrams.push_back(UdpSocket::OutgoingDatagram {
+            .data = reinterpret_cast<const char*>(buf.dataPtr() + offsets[i]),
+            .size = static_cast<unsigned int>(offsets[i + 1] - offsets[i]),
+            .destination = &destinations[i],
+        });
+    }
+
+    GLOBED_UNWRAP_INTO(udpSocket.sendToMany(datagrams), auto sent)
+
+    GLOBED_REQUIRE_SAFE(sent == datagrams.size(), "failed to send all packets")
+
+    if (error) {
+        return Err(std::move(*error));
+    }
+
+    return Ok();
 }
 
 void GameSocket::cleanupBox() {
@@ -179,6 +549,26 @@ void GameSocket::togglePacketLogging(bool state) {
     dumpPackets = state;
 }
 
+#ifdef GLOBED_DEBUG
+Result<> GameSocket::connectLoopbackPair(GameSocket& a, GameSocket& b) {
+    a.createBox();
+    b.createBox();
+    a.cryptoBox->setPeerKey(b.cryptoBox->getPublicKey());
+    b.cryptoBox->setPeerKey(a.cryptoBox->getPublicKey());
+
+    GLOBED_UNWRAP_INTO(a.udpSocket.localPort(), auto portA);
+    GLOBED_UNWRAP_INTO(b.udpSocket.localPort(), auto portB);
+    GLOBED_UNWRAP(a.udpSocket.connect(NetworkAddress("127.0.0.1", portB)));
+    GLOBED_UNWRAP(b.udpSocket.connect(NetworkAddress("127.0.0.1", portA)));
+
+    return Ok();
+}
+#endif
+
+const NetworkStats& GameSocket::getStats() const {
+    return stats;
+}
+
 Result<PollResult> GameSocket::poll(int timeoutMs) {
     if (!tcpSocket.connected) {
         GLOBED_UNWRAP_INTO(udpSocket.poll(timeoutMs), auto res);
@@ -212,7 +602,35 @@ Result<PollResult> GameSocket::poll(int timeoutMs) {
     }
 }
 
-Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
+Result<GameSocket::PollEvents> GameSocket::poll(int timeoutMs, const WakeupSocket& wakeup) {
+    GLOBED_SOCKET_POLLFD fds[3];
+    size_t count = 2;
+
+    fds[0].fd = wakeup.socket_;
+    fds[0].events = POLLIN;
+    fds[1].fd = udpSocket.socket_;
+    fds[1].events = POLLIN;
+
+    if (tcpSocket.connected) {
+        fds[2].fd = tcpSocket.socket_;
+        fds[2].events = POLLIN;
+        count = 3;
+    }
+
+    int result = GLOBED_SOCKET_POLL(fds, count, timeoutMs);
+
+    if (result == -1) {
+        return Err(util::net::lastErrorString());
+    }
+
+    return Ok(PollEvents {
+        .tcp = count == 3 && (fds[2].revents & (POLLIN | POLLHUP | POLLERR)),
+        .udp = (bool) (fds[1].revents & POLLIN),
+        .wakeup = (bool) (fds[0].revents & POLLIN),
+    });
+}
+
+Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer, std::vector<std::pair<size_t, size_t>>* deferredEncryption) {
     PacketHeader header = {
         .id = packet.getPacketId(),
         .encrypted = packet.getEncrypted(),
@@ -220,9 +638,19 @@ Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
 
     bool tcp = packet.getUseTcp();
 
-    // reserve space for packet length when using TCP
+    auto startTime = util::time::now();
     size_t startPos = buffer.getPosition();
 
+    // reserve the exact amount of space the packet will take, so that encoding never has to reallocate
+    buffer.reserve(
+        startPos
+        + (tcp ? sizeof(uint32_t) : 0)
+        + PacketHeader::SIZE
+        + packet.encodedSize()
+        + (header.encrypted ? CryptoBox::PREFIX_LEN : 0)
+    );
+
+    // reserve space for packet length when using TCP
     if (tcp) {
         buffer.writeU32(0);
     }
@@ -241,7 +669,12 @@ Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
         }
 
         auto rawSize = buffer.size() - headerSize - startPos - CryptoBox::PREFIX_LEN;
-        cryptoBox->encryptInPlace(buffer.data().data() + startPos + headerSize, rawSize);
+
+        if (deferredEncryption) {
+            deferredEncryption->push_back({startPos + headerSize, rawSize});
+        } else {
+            cryptoBox->encryptInPlace(buffer.data().data() + startPos + headerSize, rawSize);
+        }
     }
 
     // write length
@@ -254,16 +687,25 @@ Result<> GameSocket::encodePacket(Packet& packet, ByteBuffer& buffer) {
         buffer.setPosition(lastPos);
     }
 
+    stats.recordOutgoing(header.id, buffer.size() - startPos, util::time::as<util::time::micros>(util::time::now() - startTime));
+
     return Ok();
 }
 
-Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
+Result<std::span<byte>> GameSocket::decryptPacket(ByteBuffer& buffer) {
+    GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to decrypt a packet when no cryptobox is initialized")
+    GLOBED_REQUIRE_SAFE(buffer.size() >= PacketHeader::SIZE, "packet is too short")
+
+    return cryptoBox->decryptInPlaceView(buffer.dataPtr() + PacketHeader::SIZE, buffer.size() - PacketHeader::SIZE);
+}
+
+Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer, const std::span<byte>* plaintext) {
+    auto startTime = util::time::now();
+    size_t totalSize = buffer.size();
+
     // read header
     auto header = buffer.readValue<PacketHeader>().unwrap(); // we know that the header must be present by now.
 
-    // packet size without the header
-    size_t messageLength = buffer.size() - buffer.getPosition();
-
     auto packet = matchPacket(header.id);
 
     GLOBED_REQUIRE_SAFE(packet.get() != nullptr, std::string("invalid server-side packet: ") + std::to_string(header.id))
@@ -272,23 +714,34 @@ Result<std::shared_ptr<Packet>> GameSocket::decodePacket(ByteBuffer& buffer) {
         GLOBED_REQUIRE_SAFE(false, "server sent a cleartext packet when expected an encrypted one")
     }
 
+    // encrypted packets are decoded right where the plaintext ends up, after the nonce and the MAC
+    ByteBuffer plaintextBuf;
+    ByteBuffer* body = &buffer;
+
     if (header.encrypted) {
-        GLOBED_REQUIRE_SAFE(cryptoBox.get() != nullptr, "attempted to decrypt a packet when no cryptobox is initialized")
-        bytevector& bufvec = buffer.data();
+        std::span<byte> decrypted;
 
-        GLOBED_UNWRAP_INTO(cryptoBox->decryptInPlace(bufvec.data() + PacketHeader::SIZE, messageLength), messageLength);
-        buffer.resize(messageLength + PacketHeader::SIZE);
+        if (plaintext) {
+            decrypted = *plaintext;
+        } else {
+            GLOBED_UNWRAP_INTO(this->decryptPacket(buffer), decrypted);
+        }
+
+        plaintextBuf = ByteBuffer::view(decrypted.data(), decrypted.size());
+        body = &plaintextBuf;
     }
 
     if (dumpPackets) {
-        this->dumpPacket(header.id, buffer, false);
+        this->dumpPacket(header.id, *body, false);
     }
 
-    auto result = packet->decode(buffer);
+    auto result = packet->decode(*body);
     if (result.isErr()) {
         return Err(fmt::format("Decoding packet ID {} failed: {}", header.id, ByteBuffer::strerror(result.unwrapErr())));
     }
 
+    stats.recordIncoming(header.id, totalSize, util::time::as<util::time::micros>(util::time::now() - startTime));
+
     return Ok(std::move(packet));
 }
 
@@ -306,6 +759,5 @@ void GameSocket::dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending) {
 
     std::ofstream fs(filepath, std::ios::binary);
 
-    const auto& vec = buffer.data();
-    fs.write(reinterpret_cast<const char*>(vec.data()), vec.size());
+    fs.write(reinterpret_cast<const char*>(buffer.dataPtr()), buffer.size());
 }
\ No newline at end of file
@@ -3,19 +3,39 @@
 #include "address.hpp"
 #include "udp_socket.hpp"
 #include "tcp_socket.hpp"
+#include "wakeup_socket.hpp"
+#include "stats.hpp"
+#include "crypto_pipeline.hpp"
 
 #include <data/packets/packet.hpp>
 #include <crypto/box.hpp>
 
+#include <deque>
+
 class GLOBED_DLL GameSocket {
     static constexpr uint8_t MARKER_CONN_INITIAL = 0xe0;
     static constexpr uint8_t MARKER_CONN_RECOVERY = 0xe1;
 
+    // Packet ID of a UDP datagram carrying multiple packets (protocol 13 and newer).
+    // After the usual packet header, every packet is prefixed with its length as a u16.
+    static constexpr packetid_t BATCH_PACKET_ID = 0;
+    static constexpr size_t BATCH_OVERHEAD = PacketHeader::SIZE + sizeof(uint16_t);
+
+    // Upper bound on the size of a batch, whatever limit is passed to `setUdpBatching`. A larger datagram gets fragmented by IP
+    // and losing any one fragment loses every packet in it. This leaves room for IP and UDP headers in the 1280 byte IPv6 minimum MTU.
+    static constexpr size_t BATCH_MTU = 1200;
+
 public:
     GameSocket();
     ~GameSocket();
 
-    Result<> connect(const NetworkAddress& address, bool isRecovering);
+    // Connect to the server. If `initialPacket` is set, it is sent together with the connection marker in a single write,
+    // so the server can start processing it without waiting for another round trip.
+    Result<> connect(const NetworkAddress& address, std::shared_ptr<Packet> initialPacket = nullptr);
+
+    // Reconnect the TCP socket after the connection was lost and ask the server to resume the session.
+    // The crypto keys and the UDP socket are kept as is, so UDP packets keep flowing while this is in progress.
+    Result<> resume(const NetworkAddress& address, int accountId, uint32_t secretKey);
     void disconnect();
     bool isConnected();
 
@@ -24,12 +44,20 @@ public:
         bool fromConnected;
     };
 
-    // Try to receive a packet on the TCP socket
+    // Receive a packet on the TCP socket. Must only be called once `poll` reports TCP data, or while `hasPendingTCP` is true.
+    // Reads at most once, so it never blocks. Returns nullptr if the frame is not complete yet, the rest is read on later calls.
     Result<std::shared_ptr<Packet>> recvPacketTCP();
 
-    // Try to receive a packet on the UDP socket
+    // Whether a complete TCP frame is already buffered, which `recvPacketTCP` will return without reading anything
+    bool hasPendingTCP();
+
+    // Try to receive a packet on the UDP socket. All datagrams that are ready get received at once,
+    // packets after the first one are returned by the next calls.
     Result<ReceivedPacket> recvPacketUDP();
 
+    // Whether `recvPacketUDP` has packets left over from an earlier receive, which it will return without receiving anything
+    bool hasPendingUDP();
+
     // Try to receive a packet
     Result<ReceivedPacket> recvPacket();
 
@@ -39,38 +67,114 @@ public:
     // Send a packet to the currently active connection. Throws if disconnected
     Result<> sendPacket(std::shared_ptr<Packet> packet);
 
+    // Like `sendPacket`, but if batching is enabled, UDP packets are held back until `flushPackets`
+    // and then sent together in as few datagrams as possible
+    Result<> queuePacket(std::shared_ptr<Packet> packet);
+
+    // Send all packets held back by `queuePacket`
+    Result<> flushPackets();
+
+    // Enable packing multiple UDP packets into datagrams of at most `limit` (capped at `BATCH_MTU`) bytes. The server must support protocol 13.
+    void setUdpBatching(bool enabled, size_t limit);
+
     // Send a UDP packet to a specific address
     Result<> sendPacketTo(std::shared_ptr<Packet> packet, const NetworkAddress& address);
 
-    Result<> sendRecoveryData(int accountId, uint32_t secretKey);
+    // Send UDP packets to multiple addresses at once. If an address fails to resolve, the rest are still sent and the error is returned.
+    Result<> sendPacketsTo(std::span<const std::pair<std::shared_ptr<Packet>, NetworkAddress>> packets);
 
     void cleanupBox();
     void createBox();
 
+    // Decrypt bursts of incoming UDP packets and encrypt batched outgoing ones on `workers` extra threads. 0 does all crypto inline.
+    void setCryptoWorkers(size_t workers);
+
     void togglePacketLogging(bool enabled);
 
+#ifdef GLOBED_DEBUG
+    // Connect the UDP sockets of `a` and `b` to each other over loopback and give them each other's keys, without any server.
+    // Only meant for benchmarks, a real connection goes through `connect`.
+    static Result<> connectLoopbackPair(GameSocket& a, GameSocket& b);
+#endif
+
+    const NetworkStats& getStats() const;
+
     enum class PollResult {
         None, Tcp, Udp, Both
     };
 
     Result<PollResult> poll(int timeoutMs);
 
+    struct PollEvents {
+        bool tcp = false;
+        bool udp = false;
+        bool wakeup = false;
+    };
+
+    // Waits until either socket has data or `wakeup` gets woken up. Negative timeout waits indefinitely.
+    Result<PollEvents> poll(int timeoutMs, const WakeupSocket& wakeup);
+
 private:
     friend class NetworkManager;
 
+    // A packet received over UDP that is yet to be decoded
+    struct IncomingPacket {
+        ByteBuffer buffer; // view into `udpRecvBatch`, starting at the packet header
+        bool fromConnected;
+        bool encrypted;
+
+        // set by the decryption stage for encrypted packets
+        std::span<util::data::byte> plaintext;
+        std::optional<std::string> decryptError;
+    };
+
     TcpSocket tcpSocket;
     UdpSocket udpSocket;
+    NetworkStats stats;
 
     std::unique_ptr<CryptoBox> cryptoBox;
     util::data::byte* dataBuffer;
+    // received TCP data in `dataBuffer` that wasn't decoded yet, which may end with an incomplete frame
+    size_t tcpRecvStart = 0, tcpRecvEnd = 0;
 
     bool dumpPackets = false;
 
+    bool udpBatching = false;
+    size_t udpBatchLimit = 0;
+    size_t udpBatchCount = 0;
+    ByteBuffer udpBatch;
+    UdpRecvBatch udpRecvBatch;
+    std::deque<ReceivedPacket> pendingUdpPackets;
+    std::vector<IncomingPacket> incomingUdp;
+
+    std::unique_ptr<CryptoPipeline> cryptoPipeline;
+    // encrypted packets in `udpBatch` that get encrypted right before it is sent, as (offset, plaintext size)
+    std::vector<std::pair<size_t, size_t>> udpBatchEncryption;
+
     // Write a packet, packet header, and optionally length if the packet is TCP to the given buffer.
-    Result<> encodePacket(Packet& packet, ByteBuffer& buffer);
+    // If `deferredEncryption` is set, an encrypted packet is left as plaintext (with space for the prefix) and added to it instead.
+    Result<> encodePacket(Packet& packet, ByteBuffer& buffer, std::vector<std::pair<size_t, size_t>>* deferredEncryption = nullptr);
+
+    // Decrypt the packet in `buffer`, which starts with the packet header. Safe to call from any thread.
+    Result<std::span<util::data::byte>> decryptPacket(ByteBuffer& buffer);
+
+    // Returns the size of the first frame in the TCP receive buffer (including the length prefix) if all of it was received
+    Result<std::optional<size_t>> bufferedTcpFrame();
+
+    // Decode a packet from a buffer. If the packet is encrypted and `plaintext` is set, it was already decrypted by `decryptPacket`.
+    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer, const std::span<util::data::byte>* plaintext = nullptr);
+
+    // Split a single UDP datagram (batched or not) into packets in `incomingUdp`
+    Result<> splitDatagram(ByteBuffer& buffer, bool fromConnected);
+
+    // Split a batched datagram into packets in `incomingUdp`
+    Result<> unpackBatch(ByteBuffer& buffer, bool fromConnected);
+
+    // Decrypt and decode everything in `incomingUdp` into `pendingUdpPackets`, keeping the order. Stores the first error in `error`.
+    void decodeIncoming(std::optional<std::string>& error);
 
-    // Decode a packet from a buffer
-    Result<std::shared_ptr<Packet>> decodePacket(ByteBuffer& buffer);
+    // Encrypt the packets in `udpBatch` that were left for later by `queuePacket`
+    Result<> encryptBatch();
 
     void dumpPacket(packetid_t id, ByteBuffer& buffer, bool sending);
 };
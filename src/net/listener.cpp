@@ -4,14 +4,17 @@
 
 using namespace geode::prelude;
 
-PacketListener::~PacketListener() {}
+PacketListener::~PacketListener() {
+    NetworkManager::get().unregisterPacketListener(packetId, this, false);
+}
 
-bool PacketListener::init(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal) {
+bool PacketListener::init(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal, bool coalesce) {
     this->callback = std::move(fn);
     this->packetId = packetId;
     this->owner = owner;
     this->priority = priority;
     this->isFinal = isFinal;
+    this->coalesce = coalesce;
 
     return true;
 }
@@ -20,9 +23,9 @@ void PacketListener::invokeCallback(std::shared_ptr<Packet> packet) {
     callback(std::move(packet));
 }
 
-PacketListener* PacketListener::create(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal) {
+PacketListener* PacketListener::create(packetid_t packetId, CallbackFn&& fn, CCObject* owner, int priority, bool isFinal, bool coalesce) {
     auto ret = new PacketListener;
-    if (ret->init(packetId, std::move(fn), owner, priority, isFinal)) {
+    if (ret->init(packetId, std::move(fn), owner, priority, isFinal, coalesce)) {
         ret->autorelease();
         return ret;
     }
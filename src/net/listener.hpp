@@ -10,7 +10,7 @@ public:
     ~PacketListener();
 
     // lower priority - runs earlier
-    static PacketListener* create(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal);
+    static PacketListener* create(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal, bool coalesce = false);
 
     void invokeCallback(std::shared_ptr<Packet> packet);
 
@@ -18,9 +18,10 @@ public:
     cocos2d::CCObject* owner;
     int priority;
     bool isFinal;
+    bool coalesce; // see `NetworkManager::addListener`
 
 private:
     CallbackFn callback;
 
-    bool init(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal);
+    bool init(packetid_t packetId, CallbackFn&& fn, cocos2d::CCObject* owner, int priority, bool isFinal, bool coalesce);
 };
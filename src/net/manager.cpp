@@ -3,11 +3,16 @@
 #include "address.hpp"
 #include "listener.hpp"
 #include "game_socket.hpp"
+#include "sequence_window.hpp"
+#include "wakeup_socket.hpp"
+
+#include <random>
 
 #include <Geode/ui/GeodeUI.hpp>
 #include <asp/sync.hpp>
 #include <asp/thread.hpp>
 
+#include <audio/voice_playback_manager.hpp>
 #include <data/packets/all.hpp>
 #include <defs/minimal_geode.hpp>
 #include <managers/account.hpp>
@@ -30,8 +35,8 @@ using namespace geode::prelude;
 using ConnectionState = NetworkManager::ConnectionState;
 
 static constexpr uint16_t MIN_PROTOCOL_VERSION = 12;
-static constexpr uint16_t MAX_PROTOCOL_VERSION = 12;
-static constexpr std::array SUPPORTED_PROTOCOLS = std::to_array<uint16_t>({12});
+static constexpr uint16_t MAX_PROTOCOL_VERSION = 13;
+static constexpr std::array SUPPORTED_PROTOCOLS = std::to_array<uint16_t>({12, 13});
 
 static bool isProtocolSupported(uint16_t proto) {
 #ifdef GLOBED_DEBUG
@@ -55,6 +60,27 @@ struct AtomicConnectionState {
     }
 };
 
+// Session resumption retries with exponential backoff, starting at RECOVERY_BACKOFF_BASE and capped at RECOVERY_BACKOFF_MAX
+static constexpr auto RECOVERY_BACKOFF_BASE = util::time::millis(250);
+static constexpr auto RECOVERY_BACKOFF_MAX = util::time::millis(8000);
+static constexpr uint8_t MAX_RECOVERY_ATTEMPTS = 8;
+
+// Returns how long to wait before the next recovery attempt. The delay is randomized between half and the full backoff,
+// so that clients that lost connection at the same time (e.g. the server restarted) don't all retry at once.
+static util::time::millis recoveryBackoff(uint8_t attempt) {
+    thread_local std::minstd_rand engine{std::random_device{}()};
+
+    auto backoff = std::min(RECOVERY_BACKOFF_BASE * (1 << std::min<uint8_t>(attempt, 16)), RECOVERY_BACKOFF_MAX);
+    auto half = backoff.count() / 2;
+
+    return util::time::millis(half + std::uniform_int_distribution<int64_t>(0, half)(engine));
+}
+
+// Extra threads for decrypting bursts of UDP packets (see `CryptoPipeline`), only used when there are cores to spare
+static size_t cryptoWorkerCount() {
+    return std::thread::hardware_concurrency() >= 4 ? 2 : 0;
+}
+
 static std::string formatListenerKey(packetid_t id) {
     return util::cocos::spr(fmt::format("packet-listener-{}", id));
 }
@@ -93,96 +119,206 @@ public:
             gam.authToken.lock()->clear();
 
             // clear the queue
-            while (auto t = packetQueue.tryPop());
+            packetQueue.lock()->clear();
+            queuedPackets.store(0, std::memory_order::relaxed);
 
             return;
         }
 
-        if (packetQueue.empty()) return;
+        // take all queued packets at once, so the network thread only contends for the lock once per frame
+        {
+            auto queue = packetQueue.lock();
+            if (queue->empty()) return;
 
-        // clear any dead listeners
-        this->removeDeadListeners();
+            std::swap(*queue, drainedPackets);
+            queuedPackets.store(0, std::memory_order::relaxed);
+        }
 
-        while (auto packet_ = packetQueue.tryPop()) {
-            auto& packet = packet_.value();
-            packetid_t id = packet->getPacketId();
+        this->coalescePackets();
 
-            bool invoked = false;
-            auto& lsm = listeners[id];
+        for (auto& packet : drainedPackets) {
+            if (packet) {
+                this->dispatch(packet);
+            }
+        }
 
-            // reorder them based on priority
-            std::sort(lsm.begin(), lsm.end(), [](auto& l1, auto& l2) -> bool {
-                auto r1 = l1.lock();
-                auto r2 = l2.lock();
+        drainedPackets.clear();
+    }
 
-                if (!r1) return false;
-                if (!r2) return true;
+    void registerListener(packetid_t id, PacketListener* listener) {
+#ifdef GLOBED_DEBUG
+        log::debug("Registering listener {} (id {}) for {}", listener, id, listener->owner);
+#endif
 
-                return r1->priority < r2->priority;
-            });
+        // inserting into the list that is being iterated would invalidate it, so wait until that packet is dispatched.
+        // either way, the listener gets the rest of the current batch.
+        if (dispatchingId == id) {
+            pendingListeners.emplace_back(listener);
+        } else {
+            this->insertListener(id, WeakRef(listener));
+        }
+    }
 
-            for (auto& listener : lsm) {
-                if (auto l = listener.lock()) {
-                    l->invokeCallback(packet);
+    // Called when a listener is destroyed, so that its entry doesn't linger in the list of a packet that is never received
+    void unregisterListener(packetid_t id, PacketListener* listener) {
+        auto it = listeners.find(id);
+        if (it == listeners.end()) return;
 
-                    if (l->isFinal) {
-                        break;
-                    }
-                }
-            }
+        auto& list = it->second;
+
+        // the list is being iterated, `dispatch` removes it when done
+        if (dispatchingId == id) {
+            list.hasDead = true;
+            return;
         }
+
+        this->removeDeadListeners(id, list, listener);
     }
 
-    void removeDeadListeners() {
-        for (auto& [id, listeners] : listeners) {
-            for (int i = listeners.size() - 1; i >= 0; i--) {
-#ifdef GLOBED_DEBUG
-                auto addr = addrFromWeakRef(listeners[i]);
-#endif
+    // Push a packet to the queue. Thread safe.
+    void pushPacket(std::shared_ptr<Packet> packet) {
+        auto queue = packetQueue.lock();
+        queue->push_back(std::move(packet));
+        queuedPackets.store(queue->size(), std::memory_order::relaxed);
+    }
 
-                if (!listeners[i].valid()) {
-#ifdef GLOBED_DEBUG
-                    log::debug("Unregistering listener {} (id {})", addr, id);
-#endif
-                    listeners.erase(listeners.begin() + i);
-                }
+    // Returns how many packets are waiting to be delivered on the next frame. Thread safe.
+    size_t queueDepth() const {
+        return queuedPackets.load(std::memory_order::relaxed);
+    }
+
+private:
+    struct ListenerEntry {
+        int priority;
+        bool coalesce;
+        WeakRef<PacketListener> listener;
+    };
+
+    struct ListenerList {
+        // sorted by priority, listeners with equal priority stay in the order they were added
+        std::vector<ListenerEntry> entries;
+        bool hasDead = false;
+        bool coalesce = false; // true if any of the listeners asked for it
+    };
+
+    std::unordered_map<packetid_t, ListenerList> listeners;
+    asp::Mutex<std::vector<std::shared_ptr<Packet>>> packetQueue;
+    std::atomic<size_t> queuedPackets = 0; // size of `packetQueue`, readable without locking
+    std::vector<std::shared_ptr<Packet>> drainedPackets;
+    std::vector<WeakRef<PacketListener>> pendingListeners; // registered for `dispatchingId` while it was being dispatched
+    std::optional<packetid_t> dispatchingId;
+
+    // How many of the newest packets with a latest-wins ID are kept in a batch.
+    // The interpolator needs two frames to lerp between, with only one it would snap to the newest position.
+    static constexpr size_t COALESCE_KEEP = 2;
+
+    // Drops every packet in the batch that is superseded by `COALESCE_KEEP` newer ones with the same ID, if that ID is latest-wins
+    void coalescePackets() {
+        if (drainedPackets.size() <= COALESCE_KEEP) return;
+
+        std::vector<std::pair<packetid_t, size_t>> seen;
+
+        for (auto it = drainedPackets.rbegin(); it != drainedPackets.rend(); it++) {
+            packetid_t id = (*it)->getPacketId();
+
+            auto lit = listeners.find(id);
+            if (lit == listeners.end() || !lit->second.coalesce) continue;
+
+            auto sit = std::find_if(seen.begin(), seen.end(), [id](const auto& entry) { return entry.first == id; });
+
+            if (sit == seen.end()) {
+                seen.emplace_back(id, 1);
+            } else if (sit->second < COALESCE_KEEP) {
+                sit->second++;
+            } else {
+                it->reset();
             }
         }
     }
 
-    void registerListener(packetid_t id, PacketListener* listener) {
-#ifdef GLOBED_DEBUG
-        log::debug("Registering listener {} (id {}) for {}", listener, id, listener->owner);
-#endif
+    void dispatch(const std::shared_ptr<Packet>& packet) {
+        packetid_t id = packet->getPacketId();
 
-        auto& ls = listeners[id];
+        auto it = listeners.find(id);
+        if (it == listeners.end()) return;
 
-        this->removeDeadListeners();
+        auto& list = it->second;
+        dispatchingId = id;
 
-        // verify it's not a duplicate
-        bool duped = false;
-        for (auto& l : ls) {
-            if (l.lock() == listener) {
-                duped = true;
+        for (auto& entry : list.entries) {
+            auto l = entry.listener.lock();
+            if (!l) {
+                list.hasDead = true;
+                continue;
+            }
+
+            l->invokeCallback(packet);
+
+            if (l->isFinal) {
                 break;
             }
         }
 
-        if (!duped) {
-            ls.push_back(WeakRef(listener));
-        } else {
-            log::warn("duped listener ({}, id {}, owner {}), not adding again", listener, id, listener->owner);
+        dispatchingId.reset();
+
+        if (list.hasDead) {
+            this->removeDeadListeners(id, list);
+        }
+
+        for (auto& listener : pendingListeners) {
+            this->insertListener(id, std::move(listener));
         }
+
+        pendingListeners.clear();
     }
 
-    // Push a packet to the queue. Thread safe.
-    void pushPacket(std::shared_ptr<Packet> packet) {
-        packetQueue.push(std::move(packet));
+    void insertListener(packetid_t id, WeakRef<PacketListener> listener) {
+        auto ptr = listener.lock();
+        if (!ptr) return;
+
+        auto& list = listeners[id];
+
+        if (list.hasDead) {
+            this->removeDeadListeners(id, list);
+        }
+
+        // verify it's not a duplicate
+        for (auto& entry : list.entries) {
+            if (entry.listener.lock() == ptr.data()) {
+                log::warn("duped listener ({}, id {}, owner {}), not adding again", ptr.data(), id, ptr->owner);
+                return;
+            }
+        }
+
+        auto pos = std::upper_bound(list.entries.begin(), list.entries.end(), ptr->priority, [](int priority, const ListenerEntry& entry) {
+            return priority < entry.priority;
+        });
+
+        list.entries.insert(pos, ListenerEntry {
+            .priority = ptr->priority,
+            .coalesce = ptr->coalesce,
+            .listener = std::move(listener),
+        });
+
+        list.coalesce = list.coalesce || ptr->coalesce;
     }
 
-private:
-    std::unordered_map<packetid_t, std::vector<WeakRef<PacketListener>>> listeners;
-    asp::Channel<std::shared_ptr<Packet>> packetQueue;
+    // Also removes `dying`, a listener that is being destroyed and whose weak references are still valid
+    void removeDeadListeners(packetid_t id, ListenerList& list, PacketListener* dying = nullptr) {
+        std::erase_if(list.entries, [id, dying](const ListenerEntry& entry) {
+            if (entry.listener.valid() && (!dying || addrFromWeakRef(entry.listener) != static_cast<CCObject*>(dying))) return false;
+
+#ifdef GLOBED_DEBUG
+            log::debug("Unregistering listener {} (id {})", addrFromWeakRef(entry.listener), id);
+#endif
+            return true;
+        });
+
+        list.hasDead = false;
+        list.coalesce = std::any_of(list.entries.begin(), list.entries.end(), [](const ListenerEntry& entry) {
+            return entry.coalesce;
+        });
+    }
 
     PacketListenerPool() {
         CCScheduler::get()->scheduleSelector(schedule_selector(PacketListenerPool::update), this, 0.f, false);
@@ -199,21 +335,66 @@ protected:
     struct TaskPingServers {};
     struct TaskSendPacket {
         std::shared_ptr<Packet> packet;
+        util::time::time_point enqueuedAt;
     };
     struct TaskPingActive {};
 
+    // Servers to ping in one sweep. Their addresses are resolved in parallel (see `NetworkAddress::resolveAsync`),
+    // and once the last one is done, `TaskSendPings` sends all the pings at once.
+    struct PingSweep {
+        std::vector<std::pair<std::string, NetworkAddress>> targets;
+        std::vector<std::optional<std::string>> errors; // resolve errors, one slot per target
+        std::atomic<size_t> remaining;
+    };
+
+    struct TaskSendPings {
+        std::shared_ptr<PingSweep> sweep;
+    };
+
     struct GlobalListener {
         packetid_t packetId;
         bool isFinal;
         PacketListener::CallbackFn callback;
     };
 
-    using Task = std::variant<TaskPingServers, TaskSendPacket, TaskPingActive>;
+    using Task = std::variant<TaskPingServers, TaskSendPacket, TaskPingActive, TaskSendPings>;
 
     AtomicConnectionState state;
     GameSocket socket;
-    asp::Thread<NetworkManager::Impl*> threadRecv, threadMain;
+    asp::Thread<NetworkManager::Impl*> threadNet;
     asp::Channel<Task> taskQueue;
+    std::atomic<size_t> taskQueueDepth = 0;
+    WakeupSocket wakeupSocket;
+
+    // poll never blocks for longer than this, so that the thread notices when it's being stopped
+    static constexpr int MAX_POLL_TIMEOUT_MS = 500;
+    static constexpr auto KEEPALIVE_CHECK_INTERVAL = util::time::seconds(1);
+    static constexpr auto PING_EXPIRY_INTERVAL = util::time::seconds(1);
+
+    // enqueue to send latency of outgoing packets, see `getSendLatency`
+    std::atomic<uint64_t> sendLatencySamples = 0;
+    std::atomic<uint64_t> sendLatencyTotalMicros = 0;
+    std::atomic<uint64_t> sendLatencyMaxMicros = 0;
+    // enqueue times of packets sent (or batched) during the current `processTasks`
+    std::vector<util::time::time_point> sentPacketTimes;
+
+    // when each phase of the current connection attempt finished, an unset time means it hasn't yet
+    struct ConnectPhases {
+        util::time::time_point start, resolved, tcpConnected, handshakeDone;
+    };
+
+    // started by `connect` on the main thread, the rest of the phases are marked by the network thread
+    asp::Mutex<ConnectPhases> connectPhases;
+    asp::Mutex<std::optional<NetworkManager::ConnectTimings>> lastConnectTimings;
+
+    // built by `connect` on the main thread, so the network thread can send it as soon as the handshake response arrives
+    asp::Mutex<std::shared_ptr<Packet>> pendingLogin;
+
+    // TCP packets sent while the session is being resumed, they go out once it is
+    std::vector<TaskSendPacket> deferredTcpPackets;
+
+    // sequence numbers of the received `SequencedLevelDataPacket`s, checked on the network thread and reset when leaving a level
+    asp::Mutex<SequenceWindow> levelDataWindow;
 
     // Note that we intentionally don't use Ref here,
     // as we use the destructor to know if the object owning the listener has been destroyed.
@@ -222,10 +403,14 @@ protected:
 
     // these fields are only used by us and in a safe manner, so they don't need a mutex
     NetworkAddress connectedAddress;
+    std::atomic_bool resolvingConnectAddress = false;
     std::string connectedServerId;
     util::time::time_point lastReceivedPacket;
     util::time::time_point lastSentKeepalive;
     util::time::time_point lastTcpExchange;
+    util::time::time_point nextRecoveryAttempt;
+    util::time::time_point nextKeepaliveCheck;
+    util::time::time_point nextPingExpiry;
 
     AtomicBool suspended;
     AtomicBool standalone;
@@ -239,21 +424,22 @@ protected:
     AtomicU32 serverTps;
     AtomicU16 serverProtocol;
 
+    // older servers that rejected our newest protocol, mapped to the version they asked for
+    asp::Mutex<std::unordered_map<std::string, uint16_t>> protocolFallbacks;
+
     Impl() {
         // initialize winsock
         util::net::initialize();
 
         this->setupGlobalListeners();
 
-        // start up the threads
+        socket.setCryptoWorkers(cryptoWorkerCount());
 
-        threadRecv.setLoopFunction(&NetworkManager::Impl::threadRecvFunc);
-        threadRecv.setStartFunction([] { geode::utils::thread::setName("Network Thread (in)"); });
-        threadRecv.start(this);
+        // start up the threads
 
-        threadMain.setLoopFunction(&NetworkManager::Impl::threadMainFunc);
-        threadMain.setStartFunction([] { geode::utils::thread::setName("Network Thread (out)"); });
-        threadMain.start(this);
+        threadNet.setLoopFunction(&NetworkManager::Impl::threadNetFunc);
+        threadNet.setStartFunction([] { geode::utils::thread::setName("Network Thread"); });
+        threadNet.start(this);
 
         this->resetConnectionState();
     }
@@ -262,9 +448,9 @@ protected:
         // remove all listeners
         this->removeAllListeners();
 
-        log::debug("waiting for network threads to terminate..");
-        threadRecv.stopAndWait();
-        threadMain.stopAndWait();
+        log::debug("waiting for the network thread to terminate..");
+        wakeupSocket.wake();
+        threadNet.stopAndWait();
 
         if (state != ConnectionState::Disconnected) {
             log::debug("disconnecting from the server..");
@@ -294,6 +480,12 @@ protected:
         lastReceivedPacket = {};
         lastSentKeepalive = {};
         lastTcpExchange = {};
+        nextRecoveryAttempt = {};
+        nextKeepaliveCheck = {};
+        *connectPhases.lock() = {};
+        *pendingLogin.lock() = nullptr;
+        deferredTcpPackets.clear();
+        levelDataWindow.lock()->reset();
     }
 
     /* connection and tasks */
@@ -313,6 +505,9 @@ protected:
         this->standalone = standalone;
         this->wasFromRecovery = fromRecovery;
 
+        *connectPhases.lock() = ConnectPhases { .start = util::time::now() };
+        socket.stats.reset();
+
         lastReceivedPacket = util::time::now();
         lastSentKeepalive = util::time::now();
         lastTcpExchange = util::time::now();
@@ -326,16 +521,28 @@ protected:
         recovering = false;
         recoverAttempt = 0;
 
-        state = ConnectionState::TcpConnecting;
+        // building the login touches main thread only state, and it must be ready before the network thread starts connecting
+        *pendingLogin.lock() = this->buildLoginPacket();
 
-        auto& pcm = ProfileCacheManager::get();
-        pcm.setOwnDataAuto();
+        state = ConnectionState::TcpConnecting;
 
         // actual connection is deferred - the network thread does DNS resolution and TCP connection.
 
         return Ok();
     }
 
+    // Connects again from the main thread, for reconnects decided on the network thread. See `pendingLogin`.
+    void reconnectOnMainThread(bool fromRecovery) {
+        Loader::get()->queueInMainThread([this, address = connectedAddress, serverId = connectedServerId, standalone = standalone.load(), fromRecovery] {
+            auto result = this->connect(address, serverId, standalone, fromRecovery);
+
+            if (!result) {
+                log::warn("failed to reconnect: {}", result.unwrapErr());
+                this->onConnectionError("[Globed] failed to reconnect");
+            }
+        });
+    }
+
     void disconnect(bool quiet = false, bool noclear = false) {
         ConnectionState prevState = state;
 
@@ -363,6 +570,7 @@ protected:
 
     void cancelReconnect() {
         cancellingRecovery = true;
+        wakeupSocket.wake();
     }
 
     void onConnectionError(const std::string_view reason) {
@@ -370,17 +578,25 @@ protected:
     }
 
     void send(std::shared_ptr<Packet> packet) {
-        taskQueue.push(TaskSendPacket {
-            .packet = std::move(packet)
+        this->pushTask(TaskSendPacket {
+            .packet = std::move(packet),
+            .enqueuedAt = util::time::now(),
         });
     }
 
     void pingServers() {
-        taskQueue.push(TaskPingServers {});
+        this->pushTask(TaskPingServers {});
     }
 
     void updateServerPing() {
-        taskQueue.push(TaskPingActive {});
+        this->pushTask(TaskPingActive {});
+    }
+
+    void pushTask(Task&& task) {
+        // counted before pushing, the network thread may pop the task and decrement before we get to it otherwise
+        taskQueueDepth.fetch_add(1, std::memory_order::relaxed);
+        taskQueue.push(std::move(task));
+        wakeupSocket.wake();
     }
 
     ConnectionState getConnectionState() {
@@ -418,6 +634,7 @@ protected:
     }
 
     void unregisterPacketListener(packetid_t packet, PacketListener* listener, bool suppressUnhandled) {
+        PacketListenerPool::get().unregisterListener(packet, listener);
     }
 
     void suppressUnhandledUntil(packetid_t id, util::time::system_time_point point) {
@@ -477,7 +694,8 @@ protected:
     void setupGlobalListeners() {
         // Connection packets
 
-        addInternalListenerSync<CryptoHandshakeResponsePacket>([this](auto packet) {
+        // handled right on the network thread, so that the login goes out without waiting for the next frame
+        addInternalListener<CryptoHandshakeResponsePacket>([this](auto packet) {
             this->onCryptoHandshakeResponse(std::move(packet));
         });
 
@@ -513,15 +731,28 @@ protected:
             log::debug("Login recovery failed, retrying regular connection");
 
             // failed to recover login, try regular connection
+            this->reconnectOnMainThread(true);
             this->disconnect(true);
-            auto result = this->connect(connectedAddress, connectedServerId, standalone, true);
+        });
 
-            if (!result) {
-                log::warn("failed to reconnect: {}", result.unwrapErr());
-                this->onConnectionError("[Globed] failed to reconnect");
-            }
+#ifdef GLOBED_VOICE_SUPPORT
+        // decoding voice is too slow for the main thread, so frames go straight to the decode thread.
+        // GJBGL still gets the packet and manages the streams.
+        addInternalListener<VoiceBroadcastPacket>([](auto packet) {
+            // read before `packet` is moved, the order in which arguments are evaluated is unspecified
+            auto* frame = &packet->frame;
+            int sender = packet->sender;
+            VoicePlaybackManager::get().queueFrameStreamed(sender, std::shared_ptr<const EncodedAudioFrame>(std::move(packet), frame), std::nullopt);
         });
 
+        addInternalListener<SequencedVoiceBroadcastPacket>([](auto packet) {
+            auto* frame = &packet->frame;
+            int sender = packet->sender;
+            uint16_t sequence = packet->sequence;
+            VoicePlaybackManager::get().queueFrameStreamed(sender, std::shared_ptr<const EncodedAudioFrame>(std::move(packet), frame), sequence);
+        });
+#endif // GLOBED_VOICE_SUPPORT
+
         addGlobalListener<ServerNoticePacket>([](auto packet) {
             ErrorQueues::get().notice(packet->message);
         });
@@ -633,13 +864,7 @@ protected:
         });
     }
 
-    void onCryptoHandshakeResponse(std::shared_ptr<CryptoHandshakeResponsePacket> packet) {
-        log::debug("handshake successful, logging in");
-        handshakeDone = true;
-
-        auto key = packet->data.key;
-
-        socket.cryptoBox->setPeerKey(key.data());
+    std::shared_ptr<Packet> buildLoginPacket() {
         auto& am = GlobedAccountManager::get();
         std::string authtoken;
 
@@ -658,7 +883,7 @@ protected:
         }
 
         auto gddata = am.gdData.lock();
-        auto pkt = LoginPacket::create(
+        return LoginPacket::create(
             gddata->accountId,
             gddata->userId,
             gddata->accountName,
@@ -668,8 +893,88 @@ protected:
             util::net::loginPlatformString(),
             settings.getPrivacyFlags()
         );
+    }
+
+    void onCryptoHandshakeResponse(std::shared_ptr<CryptoHandshakeResponsePacket> packet) {
+        log::debug("handshake successful, logging in");
+        handshakeDone = true;
+        this->markConnectPhase(&ConnectPhases::handshakeDone);
 
-        this->send(pkt);
+        auto key = packet->data.key;
+
+        socket.cryptoBox->setPeerKey(key.data());
+
+        auto login = std::exchange(*pendingLogin.lock(), nullptr);
+        if (!login) {
+            // `connect` always builds it before the state changes, so this only happens if we got disconnected in the meantime
+            this->disconnectWithMessage("handshake response arrived without a prepared login packet");
+            return;
+        }
+
+        // we are on the network thread, so send right away instead of going through the task queue
+        auto result = socket.sendPacket(std::move(login));
+
+        if (!result) {
+            auto error = result.unwrapErr();
+            log::warn("failed to send the login packet: {}", error);
+            this->onConnectionError(error);
+        }
+    }
+
+    // Stores how long the phases of the connection took, called once it's established
+    void finishConnectTimer() {
+        auto phases = std::exchange(*connectPhases.lock(), {});
+        if (phases.start == util::time::time_point{}) return;
+
+        auto now = util::time::now();
+
+        // phases that were skipped take no time
+        auto resolvedAt = std::max(phases.resolved, phases.start);
+        auto tcpConnectedAt = std::max(phases.tcpConnected, resolvedAt);
+        auto handshakeDoneAt = std::max(phases.handshakeDone, tcpConnectedAt);
+
+        NetworkManager::ConnectTimings timings = {
+            .resolve = util::time::as<util::time::micros>(resolvedAt - phases.start),
+            .tcpConnect = util::time::as<util::time::micros>(tcpConnectedAt - resolvedAt),
+            .handshake = util::time::as<util::time::micros>(handshakeDoneAt - tcpConnectedAt),
+            .login = util::time::as<util::time::micros>(now - handshakeDoneAt),
+            .total = util::time::as<util::time::micros>(now - phases.start),
+        };
+
+        log::debug(
+            "Connected in {} (resolve {}, tcp {}, handshake {}, login {})",
+            util::format::formatDuration(timings.total),
+            util::format::formatDuration(timings.resolve),
+            util::format::formatDuration(timings.tcpConnect),
+            util::format::formatDuration(timings.handshake),
+            util::format::formatDuration(timings.login)
+        );
+
+        *lastConnectTimings.lock() = timings;
+    }
+
+    std::optional<NetworkManager::ConnectTimings> getConnectTimings() {
+        return *lastConnectTimings.lock();
+    }
+
+    NetworkStats::Snapshot getNetworkStats() {
+        auto stats = socket.stats.snapshot();
+        stats.taskQueueDepth = taskQueueDepth.load(std::memory_order::relaxed);
+        stats.listenerQueueDepth = PacketListenerPool::get().queueDepth();
+
+        bool hasSequencedStream = stats.udpReceived + stats.udpLost > 0;
+
+        if (auto server = GameServerManager::get().getActiveServer()) {
+            stats.rtt = server->pingStats.avg;
+            stats.jitter = server->pingStats.jitter;
+
+            // outside of a level (or on older servers) there are no sequence numbers, use lost pings instead
+            if (!hasSequencedStream) {
+                stats.loss = server->pingStats.loss;
+            }
+        }
+
+        return stats;
     }
 
     void onLoggedIn(std::shared_ptr<LoggedInPacket> packet) {
@@ -688,6 +993,13 @@ protected:
         serverProtocol = packet->serverProtocol;
 
         state = ConnectionState::Established;
+        this->finishConnectTimer();
+
+        // pack UDP packets sent in the same tick into one datagram, no larger than what we ask the server to use (or one MTU)
+        socket.setUdpBatching(
+            this->getSessionProtocol() >= NetworkManager::PROTOCOL_UDP_BATCHING,
+            GlobedSettings::get().globed.fragmentationLimit
+        );
 
         if (recovering || wasFromRecovery) {
             recovering = false;
@@ -711,8 +1023,21 @@ protected:
             RoleManager::get().setAllRoles(allRoles);
         });
 
-        // claim the tcp thread to allow udp packets through
-        this->send(ClaimThreadPacket::create(this->secretKey));
+        // claim the tcp thread to allow udp packets through.
+        // we are on the network thread, so send right away instead of going through the task queue
+        auto claimResult = socket.sendPacket(ClaimThreadPacket::create(this->secretKey));
+        if (!claimResult) {
+            log::warn("failed to send the claim packet: {}", claimResult.unwrapErr());
+            this->onConnectionError(claimResult.unwrapErr());
+        }
+
+        // anything sent over TCP while resuming must go after the claim, but before tasks that were queued after it
+        auto deferred = std::move(deferredTcpPackets);
+        deferredTcpPackets.clear();
+
+        for (auto& task : deferred) {
+            this->handleSendPacketTask(std::move(task));
+        }
 
         // try to login as an admin if we can
         auto& am = GlobedAccountManager::get();
@@ -726,7 +1051,20 @@ protected:
     }
 
     void onProtocolMismatch(std::shared_ptr<ProtocolMismatchPacket> packet) {
-        log::warn("Failed to connect because of protocol mismatch. Server: {}, client: {}", packet->serverProtocol, this->getUsedProtocol());
+        uint16_t usedProtocol = this->getUsedProtocol();
+        log::warn("Failed to connect because of protocol mismatch. Server: {}, client: {}", packet->serverProtocol, usedProtocol);
+
+        // if the server is older but we still speak its protocol, quietly reconnect with that version instead
+        if (packet->serverProtocol < usedProtocol && usedProtocol != 0xffff && ::isProtocolSupported(packet->serverProtocol)) {
+            log::info("Retrying the connection with protocol v{}", packet->serverProtocol);
+
+            protocolFallbacks.lock()->insert_or_assign(connectedAddress.toString(), packet->serverProtocol);
+
+            this->reconnectOnMainThread(false);
+            this->disconnect(true, true);
+
+            return;
+        }
 
         // show an error telling the user to update the mod
 
@@ -768,10 +1106,36 @@ protected:
 #ifdef GLOBED_DEBUG
         return 0xffff;
 #else
-        return ignoreProtocolMismatch ? 0xffff : MAX_PROTOCOL_VERSION;
+        if (ignoreProtocolMismatch) {
+            return 0xffff;
+        }
+
+        auto fallbacks = protocolFallbacks.lock();
+        auto it = fallbacks->find(connectedAddress.toString());
+
+        return it == fallbacks->end() ? MAX_PROTOCOL_VERSION : it->second;
 #endif
     }
 
+    uint16_t getCentralProtocol() {
+#ifdef GLOBED_DEBUG
+        return 0xffff;
+#else
+        return ignoreProtocolMismatch ? 0xffff : MIN_PROTOCOL_VERSION;
+#endif
+    }
+
+    uint16_t getSessionProtocol() {
+        if (!established()) return 0;
+
+        uint16_t used = this->getUsedProtocol();
+        if (used == 0xffff) {
+            used = MAX_PROTOCOL_VERSION;
+        }
+
+        return std::min(used, serverProtocol.load());
+    }
+
     uint32_t getServerTps() {
         return established() ? serverTps.load() : 0;
     }
@@ -796,31 +1160,141 @@ protected:
 
     void resume() {
         suspended = false;
+        wakeupSocket.wake();
     }
 
     /* worker threads */
 
-    void threadRecvFunc(decltype(threadRecv)::StopToken&) {
-        if (this->suspended || state == ConnectionState::TcpConnecting) {
+    // The network thread. Sleeps in `poll` until the TCP or UDP socket has data, a task is pushed (see `pushTask`),
+    // or a timer (recovery attempt, keepalive check) is due.
+    void threadNetFunc(decltype(threadNet)::StopToken&) {
+        if (this->suspended) {
+            // nothing is sent or received while suspended, `resume` wakes us up.
+            // tasks stay queued until then
+            if (wakeupSocket.wait(MAX_POLL_TIMEOUT_MS)) {
+                wakeupSocket.drain();
+            }
+
+            return;
+        }
+
+        if (!this->updateConnection()) {
+            return;
+        }
+
+        auto now = util::time::now();
+        if (this->established() && now >= nextKeepaliveCheck) {
+            nextKeepaliveCheck = now + KEEPALIVE_CHECK_INTERVAL;
+            this->maybeSendKeepalive();
+        }
+
+        // otherwise a server that stopped responding keeps its old stats until it's pinged again
+        if (now >= nextPingExpiry) {
+            nextPingExpiry = now + PING_EXPIRY_INTERVAL;
+            GameServerManager::get().expirePings();
+        }
+
+        auto events_ = socket.poll(this->nextPollTimeout(), wakeupSocket);
+        if (!events_) {
+            this->onConnectionError(events_.unwrapErr());
+            // don't spin if the error persists
             std::this_thread::sleep_for(util::time::millis(100));
             return;
         }
 
-        auto packet_ = socket.recvPacket(100);
-        if (packet_.isErr()) {
-            auto error = std::move(packet_.unwrapErr());
-            if (error != "timed out") {
-                this->onConnectionError(error);
+        auto events = events_.unwrap();
+
+        if (events.wakeup) {
+            wakeupSocket.drain();
+        }
+
+        // while connecting, tasks wait in the queue until we are able to send them.
+        // when resuming a session, UDP packets keep going out and only TCP packets are held back.
+        if (state != ConnectionState::TcpConnecting || recovering) {
+            this->processTasks();
+        }
+
+        // prioritize TCP. a single read can hold several packets, or only a part of one,
+        // in which case the rest is read on a later iteration instead of blocking the thread until it arrives
+        if (events.tcp) {
+            do {
+                auto packet = socket.recvPacketTCP();
+                if (!packet) {
+                    this->onConnectionError(packet.unwrapErr());
+                    break;
+                }
+
+                if (auto p = std::move(packet.unwrap())) {
+                    this->handleReceivedPacket(std::move(p), true);
+                }
+            } while (socket.hasPendingTCP());
+        }
+
+        if (events.udp) {
+            // a batched datagram yields multiple packets, handle all of them before polling again
+            do {
+                auto packet = socket.recvPacketUDP();
+                if (packet) {
+                    auto received = std::move(packet.unwrap());
+                    this->handleReceivedPacket(std::move(received.packet), received.fromConnected);
+                } else {
+                    this->onConnectionError(packet.unwrapErr());
+                }
+            } while (socket.hasPendingUDP());
+        }
+    }
+
+    // Returns how long `poll` can block for, which is until the nearest timer is due
+    int nextPollTimeout() {
+        auto now = util::time::now();
+        auto timeout = util::time::millis(MAX_POLL_TIMEOUT_MS);
+
+        if (state == ConnectionState::TcpConnecting && recovering) {
+            timeout = std::min(timeout, util::time::as<util::time::millis>(nextRecoveryAttempt - now));
+        }
+
+        if (this->established()) {
+            timeout = std::min(timeout, util::time::as<util::time::millis>(nextKeepaliveCheck - now));
+        }
+
+        return std::max<int>(0, timeout.count());
+    }
+
+    void processTasks() {
+        while (auto task_ = taskQueue.tryPop()) {
+            taskQueueDepth.fetch_sub(1, std::memory_order::relaxed);
+            auto task = std::move(task_.value());
+
+            if (std::holds_alternative<TaskPingServers>(task)) {
+                this->handlePingTask();
+            } else if (std::holds_alternative<TaskSendPacket>(task)) {
+                this->handleSendPacketTask(std::move(std::get<TaskSendPacket>(task)));
+            } else if (std::holds_alternative<TaskPingActive>(task)) {
+                this->handlePingActive();
+            } else if (std::holds_alternative<TaskSendPings>(task)) {
+                this->handleSendPings(std::move(std::get<TaskSendPings>(task)));
             }
+        }
 
+        // send out everything that was batched together
+        auto result = socket.flushPackets();
+        if (!result) {
+            auto error = result.unwrapErr();
+            log::debug("failed to send batched packets: {}", error);
+            this->onConnectionError(error);
+            sentPacketTimes.clear();
             return;
         }
 
-        // this is awesome
-        auto packet__ = packet_.unwrap();
-        auto packet = std::move(packet__.packet);
-        bool fromServer = packet__.fromConnected;
+        auto now = util::time::now();
+        for (auto enqueuedAt : sentPacketTimes) {
+            this->recordSendLatency(util::time::as<util::time::micros>(now - enqueuedAt));
+        }
+
+        sentPacketTimes.clear();
+    }
 
+    void handleReceivedPacket(std::shared_ptr<Packet> packet, bool fromServer) {
         packetid_t id = packet->getPacketId();
 
         if (id == PingResponsePacket::PACKET_ID) {
@@ -835,9 +1309,28 @@ protected:
 
         lastReceivedPacket = util::time::now();
 
+        // level data is coalesced on the main thread, so sequence numbers are checked here, where every packet still passes through
+        if (auto* levelData = packet->tryDowncast<SequencedLevelDataPacket>()) {
+            if (!this->acceptLevelData(levelData->sequence)) return;
+        }
+
         this->callListener(std::move(packet));
     }
 
+    // Returns false if the packet arrived late or twice, applying it would move players back in time
+    bool acceptLevelData(uint16_t sequence) {
+        auto window = levelDataWindow.lock();
+        auto order = window->receive(sequence);
+        socket.stats.setUdpDelivery(window->received(), window->lost());
+
+        return order == SequenceWindow::Order::New;
+    }
+
+    void resetLevelDataWindow() {
+        levelDataWindow.lock()->reset();
+        socket.stats.setUdpDelivery(0, 0);
+    }
+
     void callListener(std::shared_ptr<Packet>&& packet) {
         packetid_t packetId = packet->getPacketId();
 
@@ -861,16 +1354,25 @@ protected:
         }
     }
 
-    void threadMainFunc(decltype(threadMain)::StopToken&) {
-        if (this->suspended) {
-            std::this_thread::sleep_for(util::time::millis(100));
-            return;
-        }
-
+    // Advances connecting, recovering and authenticating. Returns false if the rest of this loop iteration should be skipped.
+    bool updateConnection() {
         // Initial tcp connection.
         if (state == ConnectionState::TcpConnecting && !recovering) {
-            // try to connect
-            auto result = socket.connect(connectedAddress, recovering);
+            if (!this->connectAddressReady()) {
+                return true;
+            }
+
+            this->markConnectPhase(&ConnectPhases::resolved);
+
+            // the handshake goes out in the same write as the connection marker
+            socket.createBox();
+
+            auto handshake = CryptoHandshakeStartPacket::create(
+                this->getUsedProtocol(),
+                CryptoPublicKey(socket.cryptoBox->extractPublicKey())
+            );
+
+            auto result = socket.connect(connectedAddress, std::move(handshake));
 
             if (!result) {
                 this->disconnect(true);
@@ -879,79 +1381,70 @@ protected:
                 log::warn("TCP connection failed: <cy>{}</c>", reason);
 
                 ErrorQueues::get().error(fmt::format("Failed to connect to the server.\n\nReason: <cy>{}</c>", reason));
-                return;
+                return false;
             } else {
-                log::debug("tcp connection successful, sending the handshake");
+                log::debug("tcp connection successful, handshake sent");
                 state = ConnectionState::Authenticating;
-
-                socket.createBox();
-
-                uint16_t proto = this->getUsedProtocol();
-
-                this->send(CryptoHandshakeStartPacket::create(
-                    proto,
-                    CryptoPublicKey(socket.cryptoBox->extractPublicKey())
-                ));
+                this->markConnectPhase(&ConnectPhases::tcpConnected);
             }
         }
         // Connection recovery loop itself
         else if (state == ConnectionState::TcpConnecting && recovering) {
-            log::debug("recovery attempt {}", recoverAttempt.load());
+            if (cancellingRecovery) {
+                log::debug("recovery attempts were cancelled.");
+                recovering = false;
+                recoverAttempt = 0;
+                state = ConnectionState::Disconnected;
+                return false;
+            }
 
-            // initiate TCP connection
-            auto result = socket.connect(connectedAddress, recovering);
+            // wait for the next attempt, `cancelReconnect` wakes us up
+            if (util::time::now() < nextRecoveryAttempt) {
+                return true;
+            }
 
-            bool failed = false;
+            this->markConnectPhase(&ConnectPhases::start);
 
-            if (!result) {
-                failed = true;
-            } else {
-                log::debug("tcp connection successful, sending recovery data");
-                state = ConnectionState::Authenticating;
+            // the server might have moved to a different IP, so the address may need to be resolved again
+            if (!this->connectAddressReady()) {
+                return true;
+            }
 
-                // if we are recovering, next steps are slightly different
-                // first send our account ID and secret key (handled on the lowest level by the server)
-                auto result = socket.sendRecoveryData(GJAccountManager::get()->m_accountID, secretKey);
+            this->markConnectPhase(&ConnectPhases::resolved);
 
-                if (!result) {
-                    failed = true;
-                } else {
-                    // the rest is done in a global listener
-                    return;
-                }
-            }
+            log::debug("recovery attempt {}", recoverAttempt.load());
 
-            if (failed) {
-                auto attemptNumber = recoverAttempt.load() + 1;
-                recoverAttempt = attemptNumber;
+            // reconnect and send our account ID and secret key (handled on the lowest level by the server).
+            // no new handshake is needed, the server keeps the session keys.
+            auto result = socket.resume(connectedAddress, GJAccountManager::get()->m_accountID, secretKey);
 
-                if (attemptNumber > 3) {
-                    // give up
-                    this->failedRecovery();
-                    return;
-                }
+            if (result) {
+                log::debug("tcp connection successful, sent recovery data");
+                state = ConnectionState::Authenticating;
+                this->markConnectPhase(&ConnectPhases::tcpConnected);
 
-                auto sleepPeriod = util::time::millis(10000) * attemptNumber;
+                // the rest is done in a global listener
+                return false;
+            }
 
-                log::debug("tcp connect failed, sleeping for {} before trying again", util::format::formatDuration(sleepPeriod));
+            auto attemptNumber = recoverAttempt.load() + 1;
+            recoverAttempt = attemptNumber;
 
-                // wait for a bit before trying again
+            if (attemptNumber >= MAX_RECOVERY_ATTEMPTS) {
+                // give up
+                this->failedRecovery();
+                return false;
+            }
 
-                // we sleep 50 times because we want to check if the user cancelled the recovery
-                for (size_t i = 0; i < 50; i++) {
-                    std::this_thread::sleep_for(sleepPeriod / 50);
+            auto sleepPeriod = recoveryBackoff(attemptNumber - 1);
 
-                    if (cancellingRecovery) {
-                        log::debug("recovery attempts were cancelled.");
-                        recovering = false;
-                        recoverAttempt = 0;
-                        state = ConnectionState::Disconnected;
-                        return;
-                    }
-                }
+            log::debug("tcp connect failed ({}), waiting for {} before trying again", result.unwrapErr(), util::format::formatDuration(sleepPeriod));
 
-                return;
-            }
+            nextRecoveryAttempt = util::time::now() + sleepPeriod;
+
+            // don't count the time between attempts
+            *connectPhases.lock() = {};
+            return false;
         }
         // Detect if the tcp socket has unexpectedly disconnected and start recovering the connection
         else if (state == ConnectionState::Established && !socket.isConnected()) {
@@ -961,7 +1454,8 @@ protected:
             recovering = true;
             cancellingRecovery = false;
             recoverAttempt = 0;
-            return;
+            nextRecoveryAttempt = {};
+            return false;
         }
         // Detect if we disconnected while authenticating, likely the server doesn't expect us
         else if (state == ConnectionState::Authenticating && !socket.isConnected()) {
@@ -971,7 +1465,7 @@ protected:
                 "Failed to connect to the server.\n\nReason: <cy>server abruptly disconnected during the {}</c>",
                 handshakeDone ? "login attempt" : "handshake"
             ));
-            return;
+            return false;
         }
         // Detect if authentication is taking too long
         else if (state == ConnectionState::Authenticating && !recovering && (util::time::now() - lastReceivedPacket) > util::time::seconds(5)) {
@@ -981,28 +1475,37 @@ protected:
                 "Failed to connect to the server.\n\nReason: <cy>server took too long to respond to the {}</c>",
                 handshakeDone ? "login attempt" : "handshake"
             ));
-            return;
+            return false;
         }
 
-        if (this->established()) {
-            this->maybeSendKeepalive();
-        }
+        return true;
+    }
 
-        // poll for any incoming packets
+    // Records the end of a connection phase, unless it was already recorded
+    void markConnectPhase(util::time::time_point ConnectPhases::* phase) {
+        auto phases = connectPhases.lock();
+        auto& time = (*phases).*phase;
 
-        while (auto task_ = taskQueue.popTimeout(util::time::millis(50))) {
-            auto task = std::move(task_.value());
+        if (time == util::time::time_point{}) {
+            time = util::time::now();
+        }
+    }
 
-            if (std::holds_alternative<TaskPingServers>(task)) {
-                this->handlePingTask();
-            } else if (std::holds_alternative<TaskSendPacket>(task)) {
-                this->handleSendPacketTask(std::move(std::get<TaskSendPacket>(task)));
-            } else if (std::holds_alternative<TaskPingActive>(task)) {
-                this->handlePingActive();
-            }
+    // Resolves `connectedAddress` in the background, so a slow DNS lookup doesn't stall the network thread.
+    // Returns true once `socket.connect` can resolve it without blocking (including when the lookup failed).
+    bool connectAddressReady() {
+        if (connectedAddress.isResolveCached()) {
+            return true;
+        }
+
+        if (!resolvingConnectAddress.exchange(true)) {
+            connectedAddress.resolveAsync([this](auto) {
+                resolvingConnectAddress = false;
+                wakeupSocket.wake();
+            });
         }
 
-        std::this_thread::yield();
+        return false;
     }
 
     void maybeSendKeepalive() {
@@ -1017,7 +1520,7 @@ protected:
         if (sinceLastPacket > util::time::seconds(20)) {
             // timed out, disconnect the tcp socket but allow to reconnect
             log::warn("timed out, time since last received packet: {}", util::format::formatDuration(sinceLastPacket));
-            socket.disconnect();
+            socket.tcpSocket.disconnect();
         } else if (sinceLastPacket > util::time::seconds(10) && sinceLastKeepalive > util::time::seconds(3)) {
             this->sendKeepalive();
         }
@@ -1040,40 +1543,89 @@ protected:
         recoverAttempt = 0;
         state = ConnectionState::Disconnected;
 
-        ErrorQueues::get().error("Connection to the server was lost. Failed to reconnect after 3 attempts.");
+        ErrorQueues::get().error(fmt::format("Connection to the server was lost. Failed to reconnect after {} attempts.", MAX_RECOVERY_ATTEMPTS));
     }
 
     void handlePingTask() {
         auto& gsm = GameServerManager::get();
         auto active = gsm.getActiveId();
 
+        auto sweep = std::make_shared<PingSweep>();
+
         for (auto& [serverId, server] : gsm.getAllServers()) {
             if (serverId == active) continue;
 
-            NetworkAddress addr(server.address);
+            sweep->targets.emplace_back(serverId, NetworkAddress(server.address));
+        }
+
+        if (sweep->targets.empty()) return;
+
+        sweep->errors.resize(sweep->targets.size());
+        sweep->remaining = sweep->targets.size();
+
+        // resolving can block on DNS, so do it off the network thread and for all servers at once.
+        // the results end up in the DNS cache, so resolving again when sending is instant.
+        for (size_t i = 0; i < sweep->targets.size(); i++) {
+            sweep->targets[i].second.resolveAsync([this, sweep, i](Result<sockaddr_storage> result) {
+                if (!result) {
+                    sweep->errors[i] = std::move(result.unwrapErr());
+                }
+
+                if (sweep->remaining.fetch_sub(1) == 1) {
+                    this->pushTask(TaskSendPings { .sweep = sweep });
+                }
+            });
+        }
+    }
+
+    void handleSendPings(TaskSendPings task) {
+        auto& gsm = GameServerManager::get();
+        auto& sweep = *task.sweep;
+
+        std::vector<std::pair<std::shared_ptr<Packet>, NetworkAddress>> pings;
+        pings.reserve(sweep.targets.size());
+
+        for (size_t i = 0; i < sweep.targets.size(); i++) {
+            auto& [serverId, addr] = sweep.targets[i];
+
+            if (sweep.errors[i]) {
+                log::debug("failed to send ping: {}", *sweep.errors[i]);
+                ErrorQueues::get().warn(*sweep.errors[i]);
+                continue;
+            }
 
 #ifdef GLOBED_DEBUG
-            auto addrString = addr.resolveToString().value_or("<unresolved>");
-            log::debug("sending ping to {}", addrString);
+            log::debug("sending ping to {}", addr.resolveToString().value_or("<unresolved>"));
 #endif
 
+            // the server list may have changed while resolving
+            if (!gsm.getServer(serverId)) continue;
+
             auto pingId = gsm.startPing(serverId);
-            auto result = socket.sendPacketTo(PingPacket::create(pingId), addr);
+            pings.emplace_back(PingPacket::create(pingId), addr);
+        }
 
-            if (result.isErr()) {
-                log::debug("failed to send ping: {}", result.unwrapErr());
-                ErrorQueues::get().warn(result.unwrapErr());
-            }
+        // send all pings with as few syscalls as possible
+        auto result = socket.sendPacketsTo(pings);
+
+        if (result.isErr()) {
+            log::debug("failed to send ping: {}", result.unwrapErr());
+            ErrorQueues::get().warn(result.unwrapErr());
         }
     }
 
     void handleSendPacketTask(TaskSendPacket task) {
         if (task.packet->getUseTcp()) {
+            if (recovering) {
+                deferredTcpPackets.push_back(std::move(task));
+                return;
+            }
+
             lastTcpExchange = util::time::now();
         }
 
         try {
-            auto result = socket.sendPacket(task.packet);
+            auto result = socket.queuePacket(task.packet);
             if (!result) {
                 auto error = result.unwrapErr();
                 log::debug("failed to send packet {}: {}", task.packet->getPacketId(), error);
@@ -1082,7 +1634,32 @@ protected:
             }
         } catch (const std::exception& e) {
             this->onConnectionError(e.what());
+            return;
         }
+
+        sentPacketTimes.push_back(task.enqueuedAt);
+    }
+
+    void recordSendLatency(util::time::micros latency_) {
+        uint64_t latency = latency_.count();
+
+        sendLatencySamples++;
+        sendLatencyTotalMicros += latency;
+
+        uint64_t prevMax = sendLatencyMaxMicros.load();
+        while (latency > prevMax && !sendLatencyMaxMicros.compare_exchange_weak(prevMax, latency)) {}
+    }
+
+    NetworkManager::SendLatency takeSendLatency() {
+        uint64_t samples = sendLatencySamples.exchange(0);
+        uint64_t total = sendLatencyTotalMicros.exchange(0);
+        uint64_t max = sendLatencyMaxMicros.exchange(0);
+
+        return NetworkManager::SendLatency {
+            .samples = samples,
+            .average = util::time::micros(samples == 0 ? 0 : total / samples),
+            .max = util::time::micros(max),
+        };
     }
 
     void handlePingActive() {
@@ -1153,8 +1730,8 @@ void NetworkManager::addListener(CCNode* target, packetid_t id, PacketListener*
     impl->addListener(target, listener);
 }
 
-void NetworkManager::addListener(CCNode* target, packetid_t id, PacketCallback&& callback, int priority, bool isFinal) {
-    auto* listener = PacketListener::create(id, std::move(callback), target, priority, isFinal);
+void NetworkManager::addListener(CCNode* target, packetid_t id, PacketCallback&& callback, int priority, bool isFinal, bool coalesce) {
+    auto* listener = PacketListener::create(id, std::move(callback), target, priority, isFinal, coalesce);
     impl->addListener(target, listener);
 }
 
@@ -1174,6 +1751,10 @@ uint16_t NetworkManager::getUsedProtocol() {
     return impl->getUsedProtocol();
 }
 
+uint16_t NetworkManager::getCentralProtocol() {
+    return impl->getCentralProtocol();
+}
+
 uint32_t NetworkManager::getServerTps() {
     return impl->getServerTps();
 }
@@ -1182,6 +1763,26 @@ uint16_t NetworkManager::getServerProtocol() {
     return impl->getServerProtocol();
 }
 
+uint16_t NetworkManager::getSessionProtocol() {
+    return impl->getSessionProtocol();
+}
+
+NetworkManager::SendLatency NetworkManager::takeSendLatency() {
+    return impl->takeSendLatency();
+}
+
+std::optional<NetworkManager::ConnectTimings> NetworkManager::getConnectTimings() {
+    return impl->getConnectTimings();
+}
+
+NetworkStats::Snapshot NetworkManager::getNetworkStats() {
+    return impl->getNetworkStats();
+}
+
+void NetworkManager::resetLevelDataWindow() {
+    impl->resetLevelDataWindow();
+}
+
 bool NetworkManager::standalone() {
     return impl->isStandalone();
 }
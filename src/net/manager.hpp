@@ -4,6 +4,9 @@
 #include <defs/platform.hpp>
 
 #include <util/singleton.hpp>
+#include <util/time.hpp>
+
+#include "stats.hpp"
 
 using packetid_t = uint16_t;
 
@@ -34,6 +37,12 @@ public:
 
     static constexpr unsigned char SERVER_MAGIC[10] = {0xdd, 0xee, 'g', 'l', 'o', 'b', 'e', 'd', 0xda, 0xee};
 
+    // First protocol version where multiple UDP packets can be sent in a single datagram
+    static constexpr uint16_t PROTOCOL_UDP_BATCHING = 13;
+
+    // First protocol version where voice frames carry sequence numbers (`SequencedVoicePacket`, `SequencedVoiceBroadcastPacket`)
+    static constexpr uint16_t PROTOCOL_SEQUENCED_VOICE = 13;
+
     enum class ConnectionState : int {
         Disconnected,    // not connected to any server
         TcpConnecting,   // attempting to establish a TCP connection
@@ -74,14 +83,18 @@ public:
     // Adds a packet listener and calls your callback function when a packet with `id` is received.
     // If there already was a callback with this packet ID, it gets replaced.
     // All callbacks are ran in the main (GD) thread.
-    void addListener(cocos2d::CCNode* target, packetid_t id, PacketCallback&& callback, int priority = 0, bool isFinal = false);
+    //
+    // If `coalesce` is true, packets with this ID are latest-wins: when several of them pile up between two frames
+    // (for example during a lag spike), only the newest two are delivered, so interpolation still has a pair of frames to work with.
+    // This applies to all listeners of this ID.
+    void addListener(cocos2d::CCNode* target, packetid_t id, PacketCallback&& callback, int priority = 0, bool isFinal = false, bool coalesce = false);
 
     // Same as addListener(packetid_t, PacketCallback) but hacky syntax xd
     template <HasPacketID Pty>
-    void addListener(cocos2d::CCNode* target, PacketCallbackSpecific<Pty>&& callback, int priority = 0, bool isFinal = false) {
+    void addListener(cocos2d::CCNode* target, PacketCallbackSpecific<Pty>&& callback, int priority = 0, bool isFinal = false, bool coalesce = false) {
         this->addListener(target, Pty::PACKET_ID, [callback = std::move(callback)](std::shared_ptr<Packet> pkt) {
             return callback(std::static_pointer_cast<Pty>(pkt));
-        }, priority, isFinal);
+        }, priority, isFinal, coalesce);
     }
 
     // Removes a listener by packet ID.
@@ -102,12 +115,48 @@ public:
     // Returns the protocol version of this client
     uint16_t getUsedProtocol();
 
+    // Returns the protocol version to report to the central server. Its API is the same in every game protocol we support,
+    // so this stays at the oldest one, which central servers that don't know about newer game protocols still accept.
+    uint16_t getCentralProtocol();
+
     // Get the TPS of the currently connected server, or 0
     uint32_t getServerTps();
 
     // Get the maximum protocol version of the currently connected server
     uint16_t getServerProtocol();
 
+    // Get the protocol version both sides agreed on (the lower of ours and the server's), or 0 if not connected
+    uint16_t getSessionProtocol();
+
+    struct SendLatency {
+        uint64_t samples;
+        util::time::micros average;
+        util::time::micros max;
+    };
+
+    // Returns how long outgoing packets waited between `send` and the actual socket write, since the last call
+    SendLatency takeSendLatency();
+
+    // How long each phase of establishing a connection took
+    struct ConnectTimings {
+        util::time::micros resolve;    // waiting for the DNS lookup
+        util::time::micros tcpConnect; // TCP connection, until the marker and the handshake (or recovery data) are sent
+        util::time::micros handshake;  // until the handshake response arrived, zero when recovering
+        util::time::micros login;      // until the server accepted the login
+        util::time::micros total;
+    };
+
+    // Returns the connect timings of the last established connection, or nullopt if there wasn't one
+    std::optional<ConnectTimings> getConnectTimings();
+
+    // Returns traffic counters since the current connection was started, along with queue depths and the latency to the active server.
+    // The traffic counters are lock-free, so this is cheap enough to call every frame.
+    NetworkStats::Snapshot getNetworkStats();
+
+    // Forget the sequence numbers of the level data received so far, called when leaving a level.
+    // Until level data arrives again, the loss in `getNetworkStats` comes from lost pings.
+    void resetLevelDataWindow();
+
     // Returns true if we are connected to a standalone game server, not tied to any central server.
     bool standalone();
 
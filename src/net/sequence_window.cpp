@@ -0,0 +1,79 @@
+#include "sequence_window.hpp"
+
+#include <bit>
+
+static_assert(SequenceWindow::WINDOW == 64, "the window must fit in the bitmap");
+
+SequenceWindow::Order SequenceWindow::receive(uint16_t sequence) {
+    if (!started) {
+        started = true;
+        newest = sequence;
+        // there is nothing to lose before the first packet
+        bits = ~uint64_t(0);
+        receivedCount++;
+        return Order::New;
+    }
+
+    int distance = static_cast<int16_t>(static_cast<uint16_t>(sequence - newest));
+
+    if (distance > 0) {
+        // everything that slides out of the window and was never received is lost
+        if (distance >= static_cast<int>(WINDOW)) {
+            lostCount += WINDOW - std::popcount(bits);
+            lostCount += distance - WINDOW;
+            bits = 0;
+        } else {
+            uint64_t leaving = bits >> (WINDOW - distance);
+            lostCount += distance - std::popcount(leaving);
+            bits <<= distance;
+        }
+
+        bits |= 1;
+        newest = sequence;
+        receivedCount++;
+        return Order::New;
+    }
+
+    if (distance == 0) {
+        return Order::Duplicate;
+    }
+
+    if (-distance > RESTART_DISTANCE) {
+        // too far behind to be a late packet, the sender must have reset its counter
+        newest = sequence;
+        bits = ~uint64_t(0);
+        receivedCount++;
+        return Order::New;
+    }
+
+    if (-distance >= static_cast<int>(WINDOW)) {
+        // already counted as lost, we can't tell whether it's a duplicate either
+        return Order::Late;
+    }
+
+    uint64_t mask = uint64_t(1) << -distance;
+    if (bits & mask) {
+        return Order::Duplicate;
+    }
+
+    bits |= mask;
+    receivedCount++;
+    return Order::Late;
+}
+
+uint64_t SequenceWindow::received() const {
+    return receivedCount;
+}
+
+uint64_t SequenceWindow::lost() const {
+    return lostCount;
+}
+
+float SequenceWindow::lossRatio() const {
+    uint64_t total = receivedCount + lostCount;
+    return total == 0 ? 0.f : static_cast<float>(lostCount) / total;
+}
+
+void SequenceWindow::reset() {
+    *this = SequenceWindow{};
+}
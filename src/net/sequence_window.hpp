@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Tracks the sequence numbers of a single stream of unreliable (UDP) packets, to detect packets
+// that arrive late or twice, and to measure how many never arrive at all.
+//
+// Sequence numbers are 16-bit and wrap around. The newest `WINDOW` sequence numbers are remembered in a bitmap,
+// a packet that is missing by the time it slides out of the window is counted as lost.
+class SequenceWindow {
+public:
+    static constexpr size_t WINDOW = 64;
+
+    // If a packet is more than this far behind the newest one, the sender is assumed to have started over (for example after reconnecting)
+    static constexpr int RESTART_DISTANCE = 1024;
+
+    enum class Order {
+        New,       // newer than every packet received so far
+        Late,      // older than the newest packet, arrived out of order
+        Duplicate, // already received
+    };
+
+    Order receive(uint16_t sequence);
+
+    // Amount of packets received (not counting duplicates) and lost so far
+    uint64_t received() const;
+    uint64_t lost() const;
+
+    // Fraction of packets that were lost, from 0 to 1
+    float lossRatio() const;
+
+    void reset();
+
+private:
+    bool started = false;
+    uint16_t newest = 0;
+    uint64_t bits = 0; // bit N is set if packet `newest - N` was received
+    uint64_t receivedCount = 0;
+    uint64_t lostCount = 0;
+};
@@ -0,0 +1,116 @@
+#include "stats.hpp"
+
+#include <algorithm>
+
+static constexpr auto RELAXED = std::memory_order::relaxed;
+
+void NetworkStats::recordOutgoing(packetid_t id, size_t bytes, util::time::micros encodeTime) {
+    packetsOut.fetch_add(1, RELAXED);
+    bytesOut.fetch_add(bytes, RELAXED);
+    encodeMicros.fetch_add(encodeTime.count(), RELAXED);
+
+    if (auto* slot = this->slotFor(id)) {
+        slot->packetsOut.fetch_add(1, RELAXED);
+        slot->bytesOut.fetch_add(bytes, RELAXED);
+    }
+}
+
+void NetworkStats::recordIncoming(packetid_t id, size_t bytes, util::time::micros decodeTime) {
+    packetsIn.fetch_add(1, RELAXED);
+    bytesIn.fetch_add(bytes, RELAXED);
+    decodeMicros.fetch_add(decodeTime.count(), RELAXED);
+
+    if (auto* slot = this->slotFor(id)) {
+        slot->packetsIn.fetch_add(1, RELAXED);
+        slot->bytesIn.fetch_add(bytes, RELAXED);
+    }
+}
+
+void NetworkStats::setUdpDelivery(uint64_t received, uint64_t lost) {
+    udpReceived.store(received, RELAXED);
+    udpLost.store(lost, RELAXED);
+}
+
+NetworkStats::Snapshot NetworkStats::snapshot() const {
+    Snapshot out = {
+        .packetsIn = packetsIn.load(RELAXED),
+        .bytesIn = bytesIn.load(RELAXED),
+        .packetsOut = packetsOut.load(RELAXED),
+        .bytesOut = bytesOut.load(RELAXED),
+        .taskQueueDepth = 0,
+        .listenerQueueDepth = 0,
+        .rtt = -1,
+        .jitter = -1,
+        .loss = 0.f,
+        .udpReceived = udpReceived.load(RELAXED),
+        .udpLost = udpLost.load(RELAXED),
+    };
+
+    if (out.udpReceived + out.udpLost > 0) {
+        out.loss = static_cast<float>(out.udpLost) / (out.udpReceived + out.udpLost);
+    }
+
+    out.avgEncodeTime = util::time::micros(out.packetsOut == 0 ? 0 : encodeMicros.load(RELAXED) / out.packetsOut);
+    out.avgDecodeTime = util::time::micros(out.packetsIn == 0 ? 0 : decodeMicros.load(RELAXED) / out.packetsIn);
+
+    for (auto& slot : slots) {
+        packetid_t id = slot.id.load(std::memory_order::acquire);
+        if (id == 0) continue;
+
+        out.perPacket.push_back(PacketCounters {
+            .id = id,
+            .packetsIn = slot.packetsIn.load(RELAXED),
+            .bytesIn = slot.bytesIn.load(RELAXED),
+            .packetsOut = slot.packetsOut.load(RELAXED),
+            .bytesOut = slot.bytesOut.load(RELAXED),
+        });
+    }
+
+    std::sort(out.perPacket.begin(), out.perPacket.end(), [](auto& a, auto& b) {
+        return a.id < b.id;
+    });
+
+    return out;
+}
+
+void NetworkStats::reset() {
+    // slots keep their IDs, only the counters are cleared
+    for (auto& slot : slots) {
+        slot.packetsIn.store(0, RELAXED);
+        slot.bytesIn.store(0, RELAXED);
+        slot.packetsOut.store(0, RELAXED);
+        slot.bytesOut.store(0, RELAXED);
+    }
+
+    packetsIn.store(0, RELAXED);
+    bytesIn.store(0, RELAXED);
+    packetsOut.store(0, RELAXED);
+    bytesOut.store(0, RELAXED);
+    encodeMicros.store(0, RELAXED);
+    decodeMicros.store(0, RELAXED);
+    udpReceived.store(0, RELAXED);
+    udpLost.store(0, RELAXED);
+}
+
+NetworkStats::Slot* NetworkStats::slotFor(packetid_t id) {
+    // 0 marks a free slot (and is the ID of batched datagrams, which are not packets themselves)
+    if (id == 0) return nullptr;
+
+    size_t start = id % TABLE_SIZE;
+
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        auto& slot = slots[(start + i) % TABLE_SIZE];
+
+        packetid_t current = slot.id.load(std::memory_order::acquire);
+        if (current == id) return &slot;
+
+        if (current == 0) {
+            // another thread may claim it at the same time, in which case `current` tells whether it was for the same ID
+            if (slot.id.compare_exchange_strong(current, id, std::memory_order::acq_rel) || current == id) {
+                return &slot;
+            }
+        }
+    }
+
+    return nullptr;
+}
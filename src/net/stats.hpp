@@ -0,0 +1,74 @@
+#pragma once
+#include <defs/platform.hpp>
+#include <util/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+using packetid_t = uint16_t;
+
+// Always-on network counters. Every counter is a relaxed atomic, so recording is cheap enough for every packet
+// and reading never blocks the network thread. Meant for diagnostics, the values are not an exact snapshot.
+class GLOBED_DLL NetworkStats {
+public:
+    struct PacketCounters {
+        packetid_t id;
+        uint64_t packetsIn, bytesIn;
+        uint64_t packetsOut, bytesOut;
+    };
+
+    struct Snapshot {
+        uint64_t packetsIn, bytesIn;
+        uint64_t packetsOut, bytesOut;
+
+        // sorted by packet ID
+        std::vector<PacketCounters> perPacket;
+
+        util::time::micros avgEncodeTime, avgDecodeTime;
+
+        size_t taskQueueDepth;     // tasks waiting for the network thread
+        size_t listenerQueueDepth; // received packets waiting for the main thread
+
+        int rtt;      // average round trip time in milliseconds, -1 if unknown
+        int jitter;   // in milliseconds, -1 if unknown
+        float loss;   // fraction of UDP packets lost, from 0 to 1. from the sequenced stream if there is one, from lost pings otherwise
+
+        // totals of the sequenced UDP stream, both 0 if there is none
+        uint64_t udpReceived, udpLost;
+    };
+
+    // Record a packet that was encoded to be sent, `bytes` includes the header
+    void recordOutgoing(packetid_t id, size_t bytes, util::time::micros encodeTime);
+
+    // Record a packet that was received and decoded, `bytes` includes the header
+    void recordIncoming(packetid_t id, size_t bytes, util::time::micros decodeTime);
+
+    // Set the totals of a sequenced UDP stream (see `SequenceWindow`), which the loss is computed from
+    void setUdpDelivery(uint64_t received, uint64_t lost);
+
+    // Returns the counters since the last `reset`. Queue depths, RTT, jitter and loss are left for `NetworkManager` to fill in.
+    Snapshot snapshot() const;
+
+    void reset();
+
+private:
+    // more than the amount of packet IDs that exist, so the table never gets crowded
+    static constexpr size_t TABLE_SIZE = 256;
+
+    struct Slot {
+        std::atomic<packetid_t> id = 0; // 0 if the slot is free
+        std::atomic<uint64_t> packetsIn = 0, bytesIn = 0;
+        std::atomic<uint64_t> packetsOut = 0, bytesOut = 0;
+    };
+
+    std::array<Slot, TABLE_SIZE> slots;
+
+    std::atomic<uint64_t> packetsIn = 0, bytesIn = 0;
+    std::atomic<uint64_t> packetsOut = 0, bytesOut = 0;
+    std::atomic<uint64_t> encodeMicros = 0, decodeMicros = 0;
+    std::atomic<uint64_t> udpReceived = 0, udpLost = 0;
+
+    // Finds the slot of a packet ID, claiming a free one if it has none yet. Returns nullptr if the table is full.
+    Slot* slotFor(packetid_t id);
+};
@@ -2,11 +2,14 @@
 
 #include "address.hpp"
 #include <util/net.hpp>
+#include <util/time.hpp>
 
 #ifdef GEODE_IS_WINDOWS
 # include <WinSock2.h>
+# include <Ws2tcpip.h>
 #else
 # include <netinet/in.h>
+# include <sys/socket.h>
 # include <fcntl.h>
 # include <poll.h>
 # include <unistd.h>
@@ -14,9 +17,97 @@
 
 using namespace geode::prelude;
 
+// Happy Eyeballs (RFC 8305): start a new connection attempt every CONNECT_ATTEMPT_DELAY until one of them succeeds
+static constexpr int CONNECT_ATTEMPT_DELAY_MS = 250;
+static constexpr int CONNECT_TIMEOUT_MS = 5000;
+
+#ifdef GEODE_IS_WINDOWS
+using socket_t = SOCKET;
+# define GLOBED_INVALID_SOCKET INVALID_SOCKET
+#else
+using socket_t = int;
+# define GLOBED_INVALID_SOCKET -1
+#endif
+
+static void closeSocket(socket_t sock) {
+#ifdef GEODE_IS_WINDOWS
+    ::closesocket(sock);
+#else
+    ::close(sock);
+#endif
+}
+
+static Result<> setSocketNonBlocking(socket_t sock, bool nb) {
+#ifdef GEODE_IS_WINDOWS
+    unsigned long mode = nb ? 1 : 0;
+    if (SOCKET_ERROR == ioctlsocket(sock, FIONBIO, &mode)) return Err(util::net::lastErrorString());
+#else
+    int flags = fcntl(sock, F_GETFL);
+
+    if (nb) {
+        if (fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0) return Err(util::net::lastErrorString());
+    } else {
+        if (fcntl(sock, F_SETFL, flags & (~O_NONBLOCK)) < 0) return Err(util::net::lastErrorString());
+    }
+#endif
+
+    return Ok();
+}
+
+// Orders the addresses so that the families alternate, keeping the relative order within each family
+static std::vector<sockaddr_storage> interleaveFamilies(const std::vector<sockaddr_storage>& addresses) {
+    if (addresses.empty()) return {};
+
+    int firstFamily = addresses.front().ss_family;
+
+    std::vector<sockaddr_storage> first, second;
+    for (auto& addr : addresses) {
+        (addr.ss_family == firstFamily ? first : second).push_back(addr);
+    }
+
+    std::vector<sockaddr_storage> out;
+    out.reserve(addresses.size());
+
+    for (size_t i = 0; i < std::max(first.size(), second.size()); i++) {
+        if (i < first.size()) out.push_back(first[i]);
+        if (i < second.size()) out.push_back(second[i]);
+    }
+
+    return out;
+}
+
+// Starts a non-blocking connection to `addr`, returns the socket
+static Result<socket_t> startConnect(const sockaddr_storage& addr) {
+    socket_t sock = socket(addr.ss_family, SOCK_STREAM, 0);
+    GLOBED_REQUIRE_SAFE(sock != GLOBED_INVALID_SOCKET, "failed to create a tcp socket: socket failed");
+
+    auto nbres = setSocketNonBlocking(sock, true);
+    if (!nbres) {
+        closeSocket(sock);
+        return Err(std::move(nbres.unwrapErr()));
+    }
+
+    if (::connect(sock, reinterpret_cast<const struct sockaddr*>(&addr), util::net::sockaddrLength(addr)) != 0) {
+        auto code = util::net::lastErrorCode();
+
+#ifdef GEODE_IS_WINDOWS
+        bool inProgress = code == WSAEWOULDBLOCK;
+#else
+        bool inProgress = code == EINPROGRESS;
+#endif
+
+        if (!inProgress) {
+            closeSocket(sock);
+            return Err(util::net::lastErrorString(code));
+        }
+    }
+
+    return Ok(sock);
+}
+
 TcpSocket::TcpSocket() : socket_(0) {
-    destAddr_ = std::make_unique<sockaddr_in>();
-    std::memset(destAddr_.get(), 0, sizeof(sockaddr_in));
+    destAddr_ = std::make_unique<sockaddr_storage>();
+    std::memset(destAddr_.get(), 0, sizeof(sockaddr_storage));
 }
 
 TcpSocket::~TcpSocket() {
@@ -24,33 +115,126 @@ TcpSocket::~TcpSocket() {
 }
 
 Result<> TcpSocket::connect(const NetworkAddress& address) {
-    destAddr_->sin_family = AF_INET;
+    GLOBED_UNWRAP_INTO(address.resolveAll(), auto resolved);
 
-    GLOBED_UNWRAP_INTO(address.resolve(), *destAddr_)
+    auto candidates = interleaveFamilies(resolved);
+
+    struct Attempt {
+        socket_t sock;
+        size_t index;
+    };
 
-    // create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    socket_ = sock;
+    std::vector<Attempt> attempts;
+    std::vector<GLOBED_SOCKET_POLLFD> fds;
+    std::string lastError;
 
-    GLOBED_REQUIRE_SAFE(sock != -1, "failed to create a tcp socket: socket failed");
+    auto closeAll = [&] {
+        for (auto& attempt : attempts) {
+            closeSocket(attempt.sock);
+        }
+        attempts.clear();
+    };
 
-    // attempt a connection with a 5 second timeout
-    GLOBED_UNWRAP(this->setNonBlocking(true));
+    auto startTime = util::time::now();
+    auto elapsedMs = [&] {
+        return (int) util::time::as<util::time::millis>(util::time::now() - startTime).count();
+    };
 
-    // on a non-blocking socket this always errors with EWOULDBLOCK, ignore the status code
-    (void) ::connect(socket_, reinterpret_cast<struct sockaddr*>(destAddr_.get()), sizeof(sockaddr_in));
+    size_t nextCandidate = 0;
+    int nextAttemptAt = 0;
+    std::optional<Attempt> winner;
+
+    while (!winner) {
+        int elapsed = elapsedMs();
+        if (elapsed >= CONNECT_TIMEOUT_MS) break;
+
+        if (nextCandidate < candidates.size() && elapsed >= nextAttemptAt) {
+            auto res = startConnect(candidates[nextCandidate]);
+            if (res) {
+                attempts.push_back(Attempt { .sock = res.unwrap(), .index = nextCandidate });
+                nextAttemptAt = elapsed + CONNECT_ATTEMPT_DELAY_MS;
+            } else {
+                // failed right away, move on to the next address without waiting
+                lastError = std::move(res.unwrapErr());
+                nextAttemptAt = elapsed;
+            }
+
+            nextCandidate++;
+            continue;
+        }
+
+        if (attempts.empty()) {
+            // nothing in flight and nothing left to try
+            if (nextCandidate >= candidates.size()) break;
+            continue;
+        }
+
+        int timeout = CONNECT_TIMEOUT_MS - elapsed;
+        if (nextCandidate < candidates.size()) {
+            timeout = std::min(timeout, std::max(nextAttemptAt - elapsed, 0));
+        }
+
+        fds.resize(attempts.size());
+        for (size_t i = 0; i < attempts.size(); i++) {
+            fds[i].fd = attempts[i].sock;
+            fds[i].events = POLLOUT;
+            fds[i].revents = 0;
+        }
+
+        int result = GLOBED_SOCKET_POLL(fds.data(), fds.size(), timeout);
+        if (result == -1) {
+            lastError = util::net::lastErrorString();
+            break;
+        }
+
+        // walk backwards so failed attempts can be removed in place
+        for (size_t i = attempts.size(); i-- > 0;) {
+            if (fds[i].revents == 0) continue;
+
+            int error = 0;
+            socklen_t errorLen = sizeof(error);
+            if (getsockopt(attempts[i].sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorLen) != 0) {
+                error = util::net::lastErrorCode();
+            }
+
+            if (error == 0 && !(fds[i].revents & (POLLERR | POLLHUP))) {
+                winner = attempts[i];
+                attempts.erase(attempts.begin() + i);
+                break;
+            }
+
+            lastError = util::net::lastErrorString(error);
+            closeSocket(attempts[i].sock);
+            attempts.erase(attempts.begin() + i);
+
+            // one attempt failed, don't wait for the delay before starting the next one
+            nextAttemptAt = elapsedMs();
+        }
+    }
 
-    GLOBED_UNWRAP(this->setNonBlocking(false));
+    closeAll();
 
-    // im crying why does this actually poll for double the length????
-    GLOBED_UNWRAP_INTO(this->poll(2500, false), auto pollResult);
+    if (!winner) {
+        if (elapsedMs() >= CONNECT_TIMEOUT_MS || lastError.empty()) {
+            return Err("connection timed out, failed to connect after 5 seconds.");
+        }
 
-    GLOBED_REQUIRE_SAFE(pollResult, "connection timed out, failed to connect after 5 seconds.")
+        return Err(fmt::format("failed to connect: {}", lastError));
+    }
+
+    socket_ = winner->sock;
+    *destAddr_ = candidates[winner->index];
+
+    GLOBED_UNWRAP(this->setNonBlocking(false));
 
     connected = true;
     return Ok();
 }
 
+const sockaddr_storage& TcpSocket::destination() const {
+    return *destAddr_;
+}
+
 Result<int> TcpSocket::send(const char* data, unsigned int dataSize) {
 #ifdef GLOBED_IS_UNIX
     constexpr int flags = MSG_NOSIGNAL;
@@ -151,20 +335,7 @@ Result<bool> TcpSocket::poll(int msDelay, bool in) {
 }
 
 Result<> TcpSocket::setNonBlocking(bool nb) {
-#ifdef GEODE_IS_WINDOWS
-    unsigned long mode = nb ? 1 : 0;
-    if (SOCKET_ERROR == ioctlsocket(socket_, FIONBIO, &mode)) return Err(util::net::lastErrorString());
-#else
-    int flags = fcntl(socket_, F_GETFL);
-
-    if (nb) {
-        if (fcntl(socket_, F_SETFL, flags | O_NONBLOCK) < 0) return Err(util::net::lastErrorString());
-    } else {
-        if (fcntl(socket_, F_SETFL, flags & (~O_NONBLOCK)) < 0) return Err(util::net::lastErrorString());
-    }
-#endif
-
-    return Ok();
+    return setSocketNonBlocking(socket_, nb);
 }
 
 void TcpSocket::maybeDisconnect() {
@@ -5,7 +5,7 @@
 #include <defs/assert.hpp>
 #include <asp/sync.hpp>
 
-struct sockaddr_in;
+struct sockaddr_storage;
 
 class TcpSocket : public Socket {
 public:
@@ -13,6 +13,7 @@ public:
     TcpSocket();
     ~TcpSocket();
 
+    // Connects to the first reachable address of `address`, racing IPv6 and IPv4 addresses (Happy Eyeballs)
     Result<> connect(const NetworkAddress& address) override;
     Result<int> send(const char* data, unsigned int dataSize) override;
     Result<> sendAll(const char* data, unsigned int dataSize);
@@ -24,6 +25,9 @@ public:
     Result<bool> poll(int msDelay, bool in = true) override;
     Result<> setNonBlocking(bool nb) override;
 
+    // The address the socket is connected to, valid after a successful `connect`
+    const sockaddr_storage& destination() const;
+
     asp::AtomicBool connected = false;
 
 #ifdef GLOBED_IS_UNIX
@@ -33,7 +37,7 @@ public:
 #endif
 
 private:
-    std::unique_ptr<sockaddr_in> destAddr_;
+    std::unique_ptr<sockaddr_storage> destAddr_;
 
     void maybeDisconnect();
 };
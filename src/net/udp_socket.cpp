@@ -2,6 +2,7 @@
 
 #include "address.hpp"
 #include <defs/assert.hpp>
+#include <defs/net.hpp>
 #include <util/net.hpp>
 
 #ifdef GEODE_IS_WINDOWS
@@ -13,11 +14,58 @@
 # include <poll.h>
 #endif
 
+/* UdpRecvBatch */
+
+struct UdpRecvBatch::Storage {
+    sockaddr_storage sources[CAPACITY];
+#ifdef GLOBED_SOCKET_MMSG
+    iovec iovecs[CAPACITY];
+    mmsghdr headers[CAPACITY];
+#endif
+};
+
+UdpRecvBatch::UdpRecvBatch()
+    : buffers(std::make_unique<util::data::byte[]>(CAPACITY * DATAGRAM_SIZE)),
+      storage(std::make_unique<Storage>()) {}
+
+UdpRecvBatch::~UdpRecvBatch() = default;
+
+size_t UdpRecvBatch::size() const {
+    return count;
+}
+
+const UdpRecvBatch::Datagram& UdpRecvBatch::operator[](size_t index) const {
+    return datagrams[index];
+}
+
+/* UdpSocket */
+
 UdpSocket::UdpSocket() : socket_(0) {
-    destAddr_ = std::make_unique<sockaddr_in>();
-    std::memset(destAddr_.get(), 0, sizeof(sockaddr_in));
+    destAddr_ = std::make_unique<sockaddr_storage>();
+    std::memset(destAddr_.get(), 0, sizeof(sockaddr_storage));
+
+    // prefer a dual-stack socket, which can talk to both IPv4 (as IPv4-mapped addresses) and IPv6 hosts.
+    // if IPv6 is unavailable on this system, fall back to IPv4 only.
+    int sock = socket(AF_INET6, SOCK_DGRAM, 0);
+    family_ = AF_INET6;
+
+    if (sock != -1) {
+        int v6only = 0;
+        if (setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char*>(&v6only), sizeof(v6only)) != 0) {
+#ifdef GEODE_IS_WINDOWS
+            ::closesocket(sock);
+#else
+            ::close(sock);
+#endif
+            sock = -1;
+        }
+    }
+
+    if (sock == -1) {
+        sock = socket(AF_INET, SOCK_DGRAM, 0);
+        family_ = AF_INET;
+    }
 
-    int sock = socket(AF_INET, SOCK_DGRAM, 0);
     socket_ = sock;
 
     GLOBED_REQUIRE(sock != -1, "failed to create a udp socket: socket failed");
@@ -28,9 +76,16 @@ UdpSocket::~UdpSocket() {
 }
 
 Result<> UdpSocket::connect(const NetworkAddress& address) {
-    destAddr_->sin_family = AF_INET;
+    GLOBED_UNWRAP_INTO(address.resolve(), auto addr);
+
+    return this->connect(addr);
+}
+
+Result<> UdpSocket::connect(const sockaddr_storage& address) {
+    sockaddr_storage addr = address;
+    GLOBED_UNWRAP(this->prepareDestination(addr));
 
-    GLOBED_UNWRAP_INTO(address.resolve(), *destAddr_)
+    *destAddr_ = addr;
 
     connected = true;
     return Ok();
@@ -39,7 +94,7 @@ Result<> UdpSocket::connect(const NetworkAddress& address) {
 Result<int> UdpSocket::send(const char* data, unsigned int dataSize) {
     GLOBED_REQUIRE_SAFE(connected, "attempting to call UdpSocket::send on a disconnected socket")
 
-    int retval = sendto(socket_, data, dataSize, 0, reinterpret_cast<struct sockaddr*>(destAddr_.get()), sizeof(sockaddr_in));
+    int retval = sendto(socket_, data, dataSize, 0, reinterpret_cast<struct sockaddr*>(destAddr_.get()), util::net::sockaddrLength(*destAddr_));
 
     if (retval == -1) {
         return Err(util::net::lastErrorString());
@@ -49,14 +104,18 @@ Result<int> UdpSocket::send(const char* data, unsigned int dataSize) {
 }
 
 Result<int> UdpSocket::sendTo(const char* data, unsigned int dataSize, const NetworkAddress& address) {
-    // stinky windows returns wsa error 10014 if sockaddr is a stack pointer
-    std::unique_ptr<sockaddr_in> addr = std::make_unique<sockaddr_in>();
+    GLOBED_UNWRAP_INTO(address.resolve(), auto addr);
 
-    addr->sin_family = AF_INET;
+    return this->sendTo(data, dataSize, addr);
+}
 
-    GLOBED_UNWRAP_INTO(address.resolve(), *addr)
+Result<int> UdpSocket::sendTo(const char* data, unsigned int dataSize, const sockaddr_storage& address) {
+    // the old "windows needs a heap sockaddr" workaround was really about the address length,
+    // which is now always the exact size of the struct
+    sockaddr_storage addr = address;
+    GLOBED_UNWRAP(this->prepareDestination(addr));
 
-    int retval = sendto(socket_, data, dataSize, 0, reinterpret_cast<struct sockaddr*>(addr.get()), sizeof(sockaddr));
+    int retval = sendto(socket_, data, dataSize, 0, reinterpret_cast<struct sockaddr*>(&addr), util::net::sockaddrLength(addr));
 
     if (retval == -1) {
         return Err(util::net::lastErrorString());
@@ -65,12 +124,22 @@ Result<int> UdpSocket::sendTo(const char* data, unsigned int dataSize, const Net
     return Ok(retval);
 }
 
+Result<> UdpSocket::prepareDestination(sockaddr_storage& address) const {
+    if (family_ == AF_INET6) {
+        util::net::mapToIPv6(address);
+    } else {
+        GLOBED_REQUIRE_SAFE(address.ss_family == AF_INET, "cannot send to an IPv6 address, IPv6 is not available on this system")
+    }
+
+    return Ok();
+}
+
 void UdpSocket::disconnect() {
     connected = false;
 }
 
 RecvResult UdpSocket::receive(char* buffer, int bufferSize) {
-    sockaddr_in source;
+    sockaddr_storage source;
     socklen_t addrLen = sizeof(source);
 
     int result = recvfrom(socket_, buffer, bufferSize, 0, reinterpret_cast<struct sockaddr*>(&source), &addrLen);
@@ -86,6 +155,126 @@ RecvResult UdpSocket::receive(char* buffer, int bufferSize) {
     };
 }
 
+Result<> UdpSocket::receiveMany(UdpRecvBatch& batch) {
+    batch.count = 0;
+
+    auto& storage = *batch.storage;
+    size_t received = 0;
+
+#ifdef GLOBED_SOCKET_MMSG
+    for (size_t i = 0; i < UdpRecvBatch::CAPACITY; i++) {
+        storage.iovecs[i].iov_base = batch.buffers.get() + i * UdpRecvBatch::DATAGRAM_SIZE;
+        storage.iovecs[i].iov_len = UdpRecvBatch::DATAGRAM_SIZE;
+
+        auto& hdr = storage.headers[i].msg_hdr;
+        std::memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = &storage.sources[i];
+        hdr.msg_namelen = sizeof(sockaddr_storage);
+        hdr.msg_iov = &storage.iovecs[i];
+        hdr.msg_iovlen = 1;
+    }
+
+    // block for the first datagram, then take whatever else is already queued
+    int result = recvmmsg(socket_, storage.headers, UdpRecvBatch::CAPACITY, MSG_WAITFORONE, nullptr);
+
+    if (result == -1) {
+        return Err(util::net::lastErrorString());
+    }
+
+    received = result;
+
+    for (size_t i = 0; i < received; i++) {
+        batch.datagrams[i].size = storage.headers[i].msg_len;
+    }
+#else
+    while (received < UdpRecvBatch::CAPACITY) {
+        // only the first receive may block
+        if (received > 0) {
+            auto ready = this->poll(0);
+            if (!ready || !ready.unwrap()) break;
+        }
+
+        socklen_t addrLen = sizeof(sockaddr_storage);
+        int result = recvfrom(
+            socket_,
+            reinterpret_cast<char*>(batch.buffers.get() + received * UdpRecvBatch::DATAGRAM_SIZE),
+            UdpRecvBatch::DATAGRAM_SIZE,
+            0,
+            reinterpret_cast<struct sockaddr*>(&storage.sources[received]),
+            &addrLen
+        );
+
+        if (result == -1) {
+            if (received > 0) break;
+            return Err(util::net::lastErrorString());
+        }
+
+        batch.datagrams[received].size = result;
+        received++;
+    }
+#endif
+
+    for (size_t i = 0; i < received; i++) {
+        auto& dgram = batch.datagrams[i];
+        dgram.data = batch.buffers.get() + i * UdpRecvBatch::DATAGRAM_SIZE;
+        dgram.fromServer = this->connected && util::net::sameSockaddr(storage.sources[i], *destAddr_);
+    }
+
+    batch.count = received;
+
+    return Ok();
+}
+
+Result<size_t> UdpSocket::sendToMany(std::span<const OutgoingDatagram> datagrams) {
+    size_t sent = 0;
+
+#ifdef GLOBED_SOCKET_MMSG
+    constexpr size_t CHUNK_SIZE = 64;
+    iovec iovecs[CHUNK_SIZE];
+    mmsghdr headers[CHUNK_SIZE];
+    sockaddr_storage addrs[CHUNK_SIZE];
+
+    while (sent < datagrams.size()) {
+        size_t count = std::min(CHUNK_SIZE, datagrams.size() - sent);
+
+        for (size_t i = 0; i < count; i++) {
+            auto& dgram = datagrams[sent + i];
+
+            addrs[i] = *dgram.destination;
+            GLOBED_UNWRAP(this->prepareDestination(addrs[i]));
+
+            iovecs[i].iov_base = const_cast<char*>(dgram.data);
+            iovecs[i].iov_len = dgram.size;
+
+            auto& hdr = headers[i].msg_hdr;
+            std::memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_name = &addrs[i];
+            hdr.msg_namelen = util::net::sockaddrLength(addrs[i]);
+            hdr.msg_iov = &iovecs[i];
+            hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(socket_, headers, count, 0);
+
+        if (result == -1) {
+            return Err(util::net::lastErrorString());
+        } else if (result == 0) {
+            break;
+        }
+
+        sent += result;
+    }
+#else
+    for (auto& dgram : datagrams) {
+        GLOBED_UNWRAP(this->sendTo(dgram.data, dgram.size, *dgram.destination));
+
+        sent++;
+    }
+#endif
+
+    return Ok(sent);
+}
+
 bool UdpSocket::close() {
     if (!connected) return true;
 
@@ -114,4 +303,36 @@ Result<bool> UdpSocket::poll(int msDelay, bool in) {
 
 Result<> UdpSocket::setNonBlocking(bool nb) {
     GLOBED_UNIMPL("UdpSocket::setNonBlocking")
+}
+
+static uint16_t sockaddrPort(const sockaddr_storage& addr) {
+    if (addr.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6&>(addr).sin6_port);
+    }
+
+    return ntohs(reinterpret_cast<const sockaddr_in&>(addr).sin_port);
+}
+
+Result<uint16_t> UdpSocket::localPort() {
+    sockaddr_storage addr = {};
+    socklen_t addrLen = sizeof(addr);
+
+    if (getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0 && sockaddrPort(addr) != 0) {
+        return Ok(sockaddrPort(addr));
+    }
+
+    // not bound yet, an all zero address is the wildcard one
+    sockaddr_storage any = {};
+    any.ss_family = family_;
+
+    if (::bind(socket_, reinterpret_cast<sockaddr*>(&any), util::net::sockaddrLength(any)) != 0) {
+        return Err(util::net::lastErrorString());
+    }
+
+    addrLen = sizeof(addr);
+    if (getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0) {
+        return Err(util::net::lastErrorString());
+    }
+
+    return Ok(sockaddrPort(addr));
 }
\ No newline at end of file
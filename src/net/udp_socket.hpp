@@ -4,7 +4,45 @@
 #include <defs/platform.hpp>
 #include <asp/sync.hpp>
 
-struct sockaddr_in;
+#include <util/data.hpp>
+
+#include <array>
+#include <span>
+
+struct sockaddr_storage;
+
+// Preallocated buffers that `UdpSocket::receiveMany` receives into, reused on every call
+class UdpRecvBatch {
+public:
+    static constexpr size_t CAPACITY = 16;
+    static constexpr size_t DATAGRAM_SIZE = 65536;
+
+    struct Datagram {
+        util::data::byte* data;
+        size_t size;
+        bool fromServer; // true if the datagram comes from the currently connected server
+    };
+
+    UdpRecvBatch();
+    ~UdpRecvBatch();
+
+    UdpRecvBatch(const UdpRecvBatch&) = delete;
+    UdpRecvBatch& operator=(const UdpRecvBatch&) = delete;
+
+    // Amount of datagrams received by the last `receiveMany`
+    size_t size() const;
+
+    const Datagram& operator[](size_t index) const;
+
+private:
+    friend class UdpSocket;
+    struct Storage;
+
+    std::unique_ptr<util::data::byte[]> buffers;
+    std::unique_ptr<Storage> storage;
+    std::array<Datagram, CAPACITY> datagrams;
+    size_t count = 0;
+};
 
 class UdpSocket : public Socket {
 public:
@@ -13,14 +51,32 @@ public:
     ~UdpSocket();
 
     Result<> connect(const NetworkAddress& address) override;
+    Result<> connect(const sockaddr_storage& address);
     Result<int> send(const char* data, unsigned int dataSize) override;
     Result<int> sendTo(const char* data, unsigned int dataSize, const NetworkAddress& address);
+    Result<int> sendTo(const char* data, unsigned int dataSize, const sockaddr_storage& address);
     RecvResult receive(char* buffer, int bufferSize) override;
+
+    // Receives every datagram that is ready (up to `UdpRecvBatch::CAPACITY`) into `batch`, blocking until at least one arrives.
+    // Uses a single `recvmmsg` call where available.
+    Result<> receiveMany(UdpRecvBatch& batch);
+
+    struct OutgoingDatagram {
+        const char* data;
+        unsigned int size;
+        const sockaddr_storage* destination;
+    };
+
+    // Sends every datagram to its own destination, using `sendmmsg` where available. Returns the amount of datagrams sent.
+    Result<size_t> sendToMany(std::span<const OutgoingDatagram> datagrams);
     bool close() override;
     virtual void disconnect();
     Result<bool> poll(int msDelay, bool in = true) override;
     Result<> setNonBlocking(bool nb) override;
 
+    // Returns the local port of this socket. If nothing was sent yet, the socket gets bound to an ephemeral port first.
+    Result<uint16_t> localPort();
+
     asp::AtomicBool connected = false;
 
 #ifdef GLOBED_IS_UNIX
@@ -30,5 +86,9 @@ public:
 #endif
 
 private:
-    std::unique_ptr<sockaddr_in> destAddr_;
+    std::unique_ptr<sockaddr_storage> destAddr_;
+    int family_; // AF_INET6 for a dual-stack socket, AF_INET if IPv6 is unavailable
+
+    // Converts `address` to the form this socket sends to, or errors if it can't be reached from this socket
+    Result<> prepareDestination(sockaddr_storage& address) const;
 };
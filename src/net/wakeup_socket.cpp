@@ -0,0 +1,82 @@
+#include "wakeup_socket.hpp"
+
+#include <defs/assert.hpp>
+#include <defs/net.hpp>
+#include <util/net.hpp>
+
+#ifdef GEODE_IS_WINDOWS
+# include <WinSock2.h>
+# include <Ws2tcpip.h>
+#else
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+# include <fcntl.h>
+# include <poll.h>
+# include <unistd.h>
+#endif
+
+WakeupSocket::WakeupSocket() {
+    addr_ = std::make_unique<sockaddr_in>();
+    std::memset(addr_.get(), 0, sizeof(sockaddr_in));
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    GLOBED_REQUIRE((int) socket_ != -1, "failed to create the wakeup socket: socket failed");
+
+    // bind to a random port on loopback and remember it, so we can send to ourselves
+    addr_->sin_family = AF_INET;
+    addr_->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr_->sin_port = 0;
+
+    GLOBED_REQUIRE(
+        ::bind(socket_, reinterpret_cast<struct sockaddr*>(addr_.get()), sizeof(sockaddr_in)) == 0,
+        fmt::format("failed to bind the wakeup socket: {}", util::net::lastErrorString())
+    );
+
+    socklen_t len = sizeof(sockaddr_in);
+    GLOBED_REQUIRE(
+        ::getsockname(socket_, reinterpret_cast<struct sockaddr*>(addr_.get()), &len) == 0,
+        fmt::format("failed to get the wakeup socket address: {}", util::net::lastErrorString())
+    );
+
+    // reads in `drain` must never block
+#ifdef GEODE_IS_WINDOWS
+    unsigned long mode = 1;
+    ioctlsocket(socket_, FIONBIO, &mode);
+#else
+    fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+WakeupSocket::~WakeupSocket() {
+#ifdef GEODE_IS_WINDOWS
+    ::closesocket(socket_);
+#else
+    ::close(socket_);
+#endif
+}
+
+void WakeupSocket::wake() {
+    if (pending.exchange(true)) return;
+
+    char byte = 0;
+    (void) ::sendto(socket_, &byte, 1, 0, reinterpret_cast<struct sockaddr*>(addr_.get()), sizeof(sockaddr_in));
+}
+
+bool WakeupSocket::wait(int timeoutMs) {
+    GLOBED_SOCKET_POLLFD fds[1];
+
+    fds[0].fd = socket_;
+    fds[0].events = POLLIN;
+
+    return GLOBED_SOCKET_POLL(fds, 1, timeoutMs) > 0;
+}
+
+void WakeupSocket::drain() {
+    char buf[16];
+    while (::recv(socket_, buf, sizeof(buf), 0) > 0) {}
+
+    // reset only after reading, otherwise a `wake` in between could have its datagram consumed here
+    // while `pending` stays set, suppressing every wakeup after it
+    pending = false;
+}
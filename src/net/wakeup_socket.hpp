@@ -0,0 +1,38 @@
+#pragma once
+#include <defs/minimal_geode.hpp>
+#include <defs/platform.hpp>
+
+#include <atomic>
+
+struct sockaddr_in;
+
+// A loopback UDP socket that sends datagrams to itself, used to interrupt a `poll` from another thread.
+// eventfd and pipes would do the same, but `WSAPoll` only accepts sockets, so this works the same on every platform.
+class WakeupSocket {
+public:
+    WakeupSocket();
+    ~WakeupSocket();
+
+    WakeupSocket(const WakeupSocket&) = delete;
+    WakeupSocket& operator=(const WakeupSocket&) = delete;
+
+    // Makes the socket readable, interrupting any `poll` on it. Thread safe.
+    // Calls made before the next `drain` are coalesced into a single datagram.
+    void wake();
+
+    // Reads all pending wakeups. Must be called before handling whatever the wakeup was for, so that no wakeups are lost.
+    void drain();
+
+    // Waits until `wake` is called or the timeout passes, without draining. Returns whether it was woken up.
+    bool wait(int timeoutMs);
+
+#ifdef GLOBED_IS_UNIX
+    int socket_ = -1;
+#else
+    size_t socket_ = 0; // pointer sized
+#endif
+
+private:
+    std::unique_ptr<sockaddr_in> addr_;
+    std::atomic_bool pending = false;
+};
@@ -4,6 +4,7 @@
 
 #include <util/misc.hpp>
 #include <arm_neon.h>
+#include <cmath>
 
 float globed::simd::arm::pcmVolume(const float* pcm, std::size_t samples) {
 #ifdef GLOBED_ARM64
@@ -32,4 +33,61 @@ float globed::simd::arm::pcmVolume(const float* pcm, std::size_t samples) {
 #endif
 }
 
+util::simd::PcmActivity globed::simd::arm::pcmActivity(const float* pcm, std::size_t samples) {
+#ifdef GLOBED_ARM64
+    if (samples < 2) {
+        return util::misc::pcmActivitySlow(pcm, samples);
+    }
+
+    // pairs (i - 1, i), the sign bits differ if the signal crossed zero between them
+    size_t alignedEnd = 1 + (samples - 1) / 4 * 4;
+
+    float32x4_t energyVec = vdupq_n_f32(0.0f);
+    uint32x4_t crossingsVec = vdupq_n_u32(0);
+
+    for (size_t i = 1; i < alignedEnd; i += 4) {
+        float32x4_t curVec = vld1q_f32(pcm + i);
+        float32x4_t prevVec = vld1q_f32(pcm + i - 1);
+
+        energyVec = vfmaq_f32(energyVec, curVec, curVec);
+
+        uint32x4_t signDiff = veorq_u32(vreinterpretq_u32_f32(curVec), vreinterpretq_u32_f32(prevVec));
+        crossingsVec = vaddq_u32(crossingsVec, vshrq_n_u32(signDiff, 31));
+    }
+
+    float energy = pcm[0] * pcm[0] + vaddvq_f32(energyVec);
+    unsigned int crossings = vaddvq_u32(crossingsVec);
+
+    for (size_t i = alignedEnd; i < samples; i++) {
+        energy += pcm[i] * pcm[i];
+        crossings += std::signbit(pcm[i]) != std::signbit(pcm[i - 1]);
+    }
+
+    return {
+        .energy = energy / samples,
+        .zeroCrossingRate = static_cast<float>(crossings) / (samples - 1),
+    };
+#else
+    return util::misc::pcmActivitySlow(pcm, samples);
+#endif
+}
+
+void globed::simd::arm::mixPcm(float* dest, const float* src, std::size_t samples, float gain) {
+#ifdef GLOBED_ARM64
+    size_t alignedSamples = samples / 4 * 4;
+
+    for (size_t i = 0; i < alignedSamples; i += 4) {
+        float32x4_t destVec = vld1q_f32(dest + i);
+        destVec = vfmaq_n_f32(destVec, vld1q_f32(src + i), gain);
+        vst1q_f32(dest + i, destVec);
+    }
+
+    for (size_t i = alignedSamples; i < samples; i++) {
+        dest[i] += src[i] * gain;
+    }
+#else
+    util::misc::mixPcmSlow(dest, src, samples, gain);
+#endif
+}
+
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <platform/basic.hpp>
+#include <util/simd.hpp>
 
 #ifdef GLOBED_ARM
 
@@ -8,6 +9,8 @@
 
 namespace globed::simd::arm {
     float pcmVolume(const float* pcm, std::size_t samples);
+    util::simd::PcmActivity pcmActivity(const float* pcm, std::size_t samples);
+    void mixPcm(float* dest, const float* src, std::size_t samples, float gain);
 }
 
 #endif
\ No newline at end of file
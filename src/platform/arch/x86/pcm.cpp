@@ -2,6 +2,9 @@
 
 #ifdef GLOBED_X86
 
+#include <util/misc.hpp>
+
+#include <bit>
 #include <cmath>
 
 namespace globed::simd::x86 {
@@ -66,6 +69,115 @@ namespace globed::simd::x86 {
 
         return sum / samples;
     }
+
+    // both look at the pairs (i - 1, i), the sign bits differ if the signal crossed zero between them
+
+    util::simd::PcmActivity pcmActivitySSE(const float* pcm, size_t samples) {
+        if (samples < 2) {
+            return util::misc::pcmActivitySlow(pcm, samples);
+        }
+
+        size_t alignedEnd = 1 + (samples - 1) / 4 * 4;
+
+        __m128 energyVec = _mm_setzero_ps();
+        unsigned int crossings = 0;
+
+        for (size_t i = 1; i < alignedEnd; i += 4) {
+            __m128 curVec = _mm_loadu_ps(pcm + i);
+            __m128 prevVec = _mm_loadu_ps(pcm + i - 1);
+
+            energyVec = _mm_add_ps(energyVec, _mm_mul_ps(curVec, curVec));
+            crossings += std::popcount(static_cast<unsigned int>(_mm_movemask_ps(_mm_xor_ps(curVec, prevVec))));
+        }
+
+        float energy = pcm[0] * pcm[0] + asp::simd::vec128sum(energyVec);
+
+        for (size_t i = alignedEnd; i < samples; i++) {
+            energy += pcm[i] * pcm[i];
+            crossings += std::signbit(pcm[i]) != std::signbit(pcm[i - 1]);
+        }
+
+        return {
+            .energy = energy / samples,
+            .zeroCrossingRate = static_cast<float>(crossings) / (samples - 1),
+        };
+    }
+
+    util::simd::PcmActivity GLOBED_FEATURE_AVX2 pcmActivityAVX2(const float* pcm, size_t samples) {
+        if (samples < 2) {
+            return util::misc::pcmActivitySlow(pcm, samples);
+        }
+
+        size_t alignedEnd = 1 + (samples - 1) / 8 * 8;
+
+        __m256 energyVec = _mm256_setzero_ps();
+        unsigned int crossings = 0;
+
+        for (size_t i = 1; i < alignedEnd; i += 8) {
+            __m256 curVec = _mm256_loadu_ps(pcm + i);
+            __m256 prevVec = _mm256_loadu_ps(pcm + i - 1);
+
+            energyVec = _mm256_add_ps(energyVec, _mm256_mul_ps(curVec, curVec));
+            crossings += std::popcount(static_cast<unsigned int>(_mm256_movemask_ps(_mm256_xor_ps(curVec, prevVec))));
+        }
+
+        float energy = pcm[0] * pcm[0] + vec256sum(energyVec);
+
+        for (size_t i = alignedEnd; i < samples; i++) {
+            energy += pcm[i] * pcm[i];
+            crossings += std::signbit(pcm[i]) != std::signbit(pcm[i - 1]);
+        }
+
+        return {
+            .energy = energy / samples,
+            .zeroCrossingRate = static_cast<float>(crossings) / (samples - 1),
+        };
+    }
+
+    void mixPcmSSE(float* dest, const float* src, size_t samples, float gain) {
+        size_t alignedSamples = samples / 4 * 4;
+
+        __m128 gainVec = _mm_set1_ps(gain);
+
+        for (size_t i = 0; i < alignedSamples; i += 4) {
+            __m128 srcVec = _mm_mul_ps(_mm_loadu_ps(src + i), gainVec);
+            _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), srcVec));
+        }
+
+        for (size_t i = alignedSamples; i < samples; i++) {
+            dest[i] += src[i] * gain;
+        }
+    }
+
+    void GLOBED_FEATURE_AVX2 mixPcmAVX2(float* dest, const float* src, size_t samples, float gain) {
+        size_t alignedSamples = samples / 8 * 8;
+
+        __m256 gainVec = _mm256_set1_ps(gain);
+
+        for (size_t i = 0; i < alignedSamples; i += 8) {
+            __m256 srcVec = _mm256_mul_ps(_mm256_loadu_ps(src + i), gainVec);
+            _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), srcVec));
+        }
+
+        for (size_t i = alignedSamples; i < samples; i++) {
+            dest[i] += src[i] * gain;
+        }
+    }
+
+    void GLOBED_FEATURE_AVX512DQ mixPcmAVX512(float* dest, const float* src, size_t samples, float gain) {
+        size_t alignedSamples = samples / 16 * 16;
+
+        __m512 gainVec = _mm512_set1_ps(gain);
+
+        for (size_t i = 0; i < alignedSamples; i += 16) {
+            __m512 srcVec = _mm512_mul_ps(_mm512_loadu_ps(src + i), gainVec);
+            _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), srcVec));
+        }
+
+        for (size_t i = alignedSamples; i < samples; i++) {
+            dest[i] += src[i] * gain;
+        }
+    }
 }
 
 #endif
\ No newline at end of file
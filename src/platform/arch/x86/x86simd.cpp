@@ -38,6 +38,28 @@ namespace globed::simd::x86 {
             return pcmVolumeSSE(pcm, samples);
         }
     }
+
+    util::simd::PcmActivity pcmActivity(const float* pcm, size_t samples) {
+        const auto& features = asp::simd::getFeatures();
+
+        if (features.avx2) {
+            return pcmActivityAVX2(pcm, samples);
+        } else {
+            return pcmActivitySSE(pcm, samples);
+        }
+    }
+
+    void mixPcm(float* dest, const float* src, size_t samples, float gain) {
+        const auto& features = asp::simd::getFeatures();
+
+        if (features.avx512dq) {
+            mixPcmAVX512(dest, src, samples, gain);
+        } else if (features.avx2) {
+            mixPcmAVX2(dest, src, samples, gain);
+        } else {
+            mixPcmSSE(dest, src, samples, gain);
+        }
+    }
 }
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <platform/basic.hpp>
+#include <util/simd.hpp>
 #include <asp/simd.hpp>
 
 #ifdef GLOBED_X86
@@ -38,6 +39,12 @@ namespace globed::simd::x86 {
     // Calculate the volume of pcm samples, picking the fastest possible implementation.
     float pcmVolume(const float* pcm, size_t samples);
 
+    // Calculate the energy and the zero-crossing rate of pcm samples, picking the fastest possible implementation.
+    util::simd::PcmActivity pcmActivity(const float* pcm, size_t samples);
+
+    // Add `src * gain` to `dest`, picking the fastest possible implementation.
+    void mixPcm(float* dest, const float* src, size_t samples, float gain);
+
 
     /* Functions written with a specific algorithm */
 
@@ -45,6 +52,13 @@ namespace globed::simd::x86 {
     float pcmVolumeSSE(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX2 pcmVolumeAVX2(const float* pcm, size_t samples);
     float GLOBED_FEATURE_AVX512DQ pcmVolumeAVX512(const float* pcm, size_t samples);
+
+    util::simd::PcmActivity pcmActivitySSE(const float* pcm, size_t samples);
+    util::simd::PcmActivity GLOBED_FEATURE_AVX2 pcmActivityAVX2(const float* pcm, size_t samples);
+
+    void mixPcmSSE(float* dest, const float* src, size_t samples, float gain);
+    void GLOBED_FEATURE_AVX2 mixPcmAVX2(float* dest, const float* src, size_t samples, float gain);
+    void GLOBED_FEATURE_AVX512DQ mixPcmAVX512(float* dest, const float* src, size_t samples, float gain);
 }
 
 #endif
\ No newline at end of file
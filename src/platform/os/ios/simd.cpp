@@ -5,3 +5,11 @@
 float util::simd::calcPcmVolume(const float* pcm, size_t samples) {
     return globed::simd::arm::pcmVolume(pcm, samples);
 }
+
+util::simd::PcmActivity util::simd::calcPcmActivity(const float* pcm, size_t samples) {
+    return globed::simd::arm::pcmActivity(pcm, samples);
+}
+
+void util::simd::mixPcm(float* dest, const float* src, size_t samples, float gain) {
+    globed::simd::arm::mixPcm(dest, src, samples, gain);
+}
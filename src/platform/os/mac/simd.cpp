@@ -16,3 +16,19 @@ float util::simd::calcPcmVolume(const float *pcm, size_t samples) {
     return globed::simd::x86::pcmVolume(pcm, samples);
 #endif
 }
+
+util::simd::PcmActivity util::simd::calcPcmActivity(const float* pcm, size_t samples) {
+#ifdef GEODE_IS_ARM_MAC
+    return globed::simd::arm::pcmActivity(pcm, samples);
+#else
+    return globed::simd::x86::pcmActivity(pcm, samples);
+#endif
+}
+
+void util::simd::mixPcm(float* dest, const float* src, size_t samples, float gain) {
+#ifdef GEODE_IS_ARM_MAC
+    globed::simd::arm::mixPcm(dest, src, samples, gain);
+#else
+    globed::simd::x86::mixPcm(dest, src, samples, gain);
+#endif
+}
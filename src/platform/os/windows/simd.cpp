@@ -6,3 +6,11 @@
 float util::simd::calcPcmVolume(const float *pcm, size_t samples) {
     return globed::simd::x86::pcmVolume(pcm, samples);
 }
+
+util::simd::PcmActivity util::simd::calcPcmActivity(const float* pcm, size_t samples) {
+    return globed::simd::x86::pcmActivity(pcm, samples);
+}
+
+void util::simd::mixPcm(float* dest, const float* src, size_t samples, float gain) {
+    globed::simd::x86::mixPcm(dest, src, samples, gain);
+}
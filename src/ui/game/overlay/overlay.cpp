@@ -1,6 +1,8 @@
 #include "overlay.hpp"
 
 #include <managers/settings.hpp>
+#include <net/manager.hpp>
+#include <util/format.hpp>
 
 using namespace geode::prelude;
 
@@ -43,6 +45,21 @@ bool GlobedOverlay::init() {
         .parent(this)
         .id("ping-label"_spr);
 
+    if (settings.networkStats) {
+        Build<CCLabelBMFont>::create("", "bigFont.fnt")
+            .opacity(static_cast<uint8_t>(settings.opacity * 255))
+            .scale(0.6f)
+            .store(statsLabel)
+            .parent(this)
+            .id("network-stats-label"_spr);
+
+        auto stats = NetworkManager::get().getNetworkStats();
+        lastBytesIn = stats.bytesIn;
+        lastBytesOut = stats.bytesOut;
+
+        this->schedule(schedule_selector(GlobedOverlay::updateNetworkStats), 1.f);
+    }
+
 #ifdef GLOBED_DEBUG
     std::string versionStr = Mod::get()->getVersion().toVString();
     Build<CCLabelBMFont>::create(versionStr.c_str(), "bigFont.fnt")
@@ -68,6 +85,44 @@ void GlobedOverlay::updatePing(uint32_t ms) {
     this->updateLayout();
 }
 
+void GlobedOverlay::updateNetworkStats(float dt) {
+    if (!statsLabel) return;
+
+    auto stats = NetworkManager::get().getNetworkStats();
+    float seconds = std::max(dt, 0.001f);
+
+    // counters get reset when reconnecting
+    uint64_t bytesIn = stats.bytesIn >= lastBytesIn ? stats.bytesIn - lastBytesIn : stats.bytesIn;
+    uint64_t bytesOut = stats.bytesOut >= lastBytesOut ? stats.bytesOut - lastBytesOut : stats.bytesOut;
+    lastBytesIn = stats.bytesIn;
+    lastBytesOut = stats.bytesOut;
+
+    if (!NetworkManager::get().established()) {
+        statsLabel->setString("");
+        this->updateLayout();
+        return;
+    }
+
+    // without sequenced level data (outside of a level, or on older servers) the loss is measured from pings,
+    // which are sent far less often, so say so
+    bool fromPings = stats.udpReceived + stats.udpLost == 0;
+
+    std::string text = fmt::format(
+        "{}/s in, {}/s out, {:.1f}% {}",
+        util::format::formatBytes(static_cast<uint64_t>(bytesIn / seconds)),
+        util::format::formatBytes(static_cast<uint64_t>(bytesOut / seconds)),
+        stats.loss * 100.f,
+        fromPings ? "ping loss" : "loss"
+    );
+
+    if (stats.jitter != -1) {
+        text += fmt::format(", {} ms jitter", stats.jitter);
+    }
+
+    statsLabel->setString(text.c_str());
+    this->updateLayout();
+}
+
 void GlobedOverlay::updateWithDisconnected() {
     auto& settings = GlobedSettings::get();
     if (!settings.overlay.enabled) return;
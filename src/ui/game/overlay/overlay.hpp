@@ -8,11 +8,16 @@ public:
     void updatePing(uint32_t ms);
     void updateWithDisconnected();
     void updateWithEditor();
+    void updateNetworkStats(float dt);
 
     static GlobedOverlay* create();
 
 private:
     cocos2d::CCLabelBMFont
         *pingLabel = nullptr,
+        *statsLabel = nullptr,
         *versionLabel = nullptr;
+
+    // previous counters, to compute the rates
+    uint64_t lastBytesIn = 0, lastBytesOut = 0;
 };
@@ -7,6 +7,15 @@
 
 using namespace geode::prelude;
 
+// sort by average ping, servers that were never reached go last
+static bool compareServers(const GameServer& a, const GameServer& b) {
+    int pa = a.pingStats.avg == -1 ? INT_MAX : a.pingStats.avg;
+    int pb = b.pingStats.avg == -1 ? INT_MAX : b.pingStats.avg;
+
+    if (pa != pb) return pa < pb;
+    return a.name < b.name;
+}
+
 bool GlobedServerList::init() {
     if (!CCLayer::init()) return false;
 
@@ -49,11 +58,27 @@ void GlobedServerList::softRefresh() {
 
     bool authenticated = NetworkManager::get().established();
 
+    bool sorted = true;
+    ServerListCell* prev = nullptr;
+
     for (auto* slc : *listLayer) {
         auto server = gsm.getServer(slc->gsview.id);
         if (server.has_value()) {
             slc->updateWith(server.value(), authenticated && slc->gsview.id == active);
         }
+
+        if (prev && compareServers(slc->gsview, prev->gsview)) {
+            sorted = false;
+        }
+
+        prev = slc;
+    }
+
+    // pings keep coming in while the list is open, keep the fastest servers on top
+    if (!sorted) {
+        listLayer->sort([](ServerListCell* a, ServerListCell* b) {
+            return compareServers(a->gsview, b->gsview);
+        });
     }
 }
 
@@ -67,8 +92,15 @@ CCArray* GlobedServerList::createServerList() {
 
     auto activeServer = gsm.getActiveId();
 
-    for (const auto& [serverId, server] : gsm.getAllServers()) {
-        bool active = authenticated && serverId == activeServer;
+    std::vector<GameServer> servers;
+    for (auto& [_, server] : gsm.getAllServers()) {
+        servers.push_back(std::move(server));
+    }
+
+    std::sort(servers.begin(), servers.end(), compareServers);
+
+    for (const auto& server : servers) {
+        bool active = authenticated && server.id == activeServer;
         auto cell = ServerListCell::create(server, active);
         ret->addObject(cell);
     }
@@ -63,7 +63,9 @@ void ServerListCell::updateWith(const GameServer& gsview, bool active) {
     labelName->setString(gsview.name.c_str());
     labelName->limitLabelWidth(205.f, 0.7f, 0.1f);
 
-    labelPing->setString(fmt::format("{} ms", gsview.ping == -1 ? "?" : std::to_string(gsview.ping)).c_str());
+    // the average is much less noisy than the latest ping
+    int ping = gsview.pingStats.avg == -1 ? gsview.ping : gsview.pingStats.avg;
+    labelPing->setString(fmt::format("{} ms", ping == -1 ? "?" : std::to_string(ping)).c_str());
     labelExtra->setString(fmt::format("Region: {}, players: {}", gsview.region, gsview.playerCount).c_str());
 
     labelName->setColor(active ? ACTIVE_COLOR : INACTIVE_COLOR);
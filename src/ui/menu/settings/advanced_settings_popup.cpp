@@ -4,6 +4,8 @@
 #include <managers/settings.hpp>
 #include <net/manager.hpp>
 #include <net/address.hpp>
+#include <net/encode_pool.hpp>
+#include <util/bench.hpp>
 #include <util/debug.hpp>
 #include <util/format.hpp>
 #include <util/ui.hpp>
@@ -44,6 +46,9 @@ bool AdvancedSettingsPopup::setup() {
         .intoMenuItem([this](auto) {
             util::debug::Benchmarker bb;
 
+            // start from a clean cache, so the second lookup actually hits DNS
+            NetworkAddress::clearDnsCache();
+
             auto res1 = bb.run([&] {
                 NetworkAddress addr1("1.1.1.1:80");
                 auto res = addr1.resolve();
@@ -68,6 +73,67 @@ bool AdvancedSettingsPopup::setup() {
         .pos(rlayout.center - CCPoint{0.f, 60.f})
         .parent(menu);
 
+    Build<ButtonSprite>::create("Pool stats", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.8f)
+        .intoMenuItem([this](auto) {
+            auto stats = EncodeBufferPool::getStats();
+            log::debug("Encode buffer pool: {} hits, {} misses", stats.hits, stats.misses);
+        })
+        .pos(rlayout.center - CCPoint{0.f, 90.f})
+        .parent(menu);
+
+    Build<ButtonSprite>::create("Benchmarks", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.8f)
+        .intoMenuItem([this](auto) {
+            util::bench::runAll();
+        })
+        .pos(rlayout.center - CCPoint{0.f, 120.f})
+        .parent(menu);
+
+    Build<ButtonSprite>::create("Net latency", "bigFont.fnt", "GJ_button_01.png", 0.75f)
+        .scale(0.8f)
+        .intoMenuItem([this](auto) {
+            auto stats = NetworkManager::get().takeSendLatency();
+            log::debug(
+                "Send latency: {} packets, avg {}, max {}",
+                stats.samples,
+                util::format::formatDuration(stats.average),
+                util::format::formatDuration(stats.max)
+            );
+
+            if (auto timings = NetworkManager::get().getConnectTimings()) {
+                log::debug(
+                    "Last connection: {} total (resolve {}, tcp {}, handshake {}, login {})",
+                    util::format::formatDuration(timings->total),
+                    util::format::formatDuration(timings->resolve),
+                    util::format::formatDuration(timings->tcpConnect),
+                    util::format::formatDuration(timings->handshake),
+                    util::format::formatDuration(timings->login)
+                );
+            }
+
+            auto net = NetworkManager::get().getNetworkStats();
+            log::debug(
+                "Traffic: {} packets in ({}), {} out ({}), avg decode {}, avg encode {}, queues: {} tasks, {} packets",
+                net.packetsIn, util::format::formatBytes(net.bytesIn),
+                net.packetsOut, util::format::formatBytes(net.bytesOut),
+                util::format::formatDuration(net.avgDecodeTime),
+                util::format::formatDuration(net.avgEncodeTime),
+                net.taskQueueDepth, net.listenerQueueDepth
+            );
+
+            for (auto& packet : net.perPacket) {
+                log::debug(
+                    "Packet {}: {} in ({}), {} out ({})",
+                    packet.id,
+                    packet.packetsIn, util::format::formatBytes(packet.bytesIn),
+                    packet.packetsOut, util::format::formatBytes(packet.bytesOut)
+                );
+            }
+        })
+        .pos(rlayout.center - CCPoint{0.f, 150.f})
+        .parent(menu);
+
     auto* thing = Build(CCMenuItemToggler::createWithStandardSprites(this, menu_selector(AdvancedSettingsPopup::onPacketLog), 0.7f))
         .parent(menu)
         .collect();
@@ -253,6 +253,9 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.communication.voiceVolume, "Voice volume", "Controls how loud other players are.");
             registerSetting(cat, settings.communication.onlyFriends, "Only friends", "When enabled, you won't hear players that are not on your friend list in-game.");
             registerSetting(cat, settings.communication.lowerAudioLatency, "Lower audio latency", "Decreases the audio buffer size by 2 times, reducing the latency but potentially causing audio issues.");
+            registerSetting(cat, settings.communication.silenceSuppression, "Silence suppression", "Stops sending your voice while you are not talking, even if push to talk is held. Saves bandwidth for you and everyone in the level.");
+            registerSetting(cat, settings.communication.silenceHangover, "Silence delay", "How long to keep sending your voice after you stop talking, in seconds. Increase this if the ends of your words get cut off.");
+            registerSetting(cat, settings.communication.voiceMixer, "Mix voices", "Plays the voices of all players through a single audio stream, instead of one per player. Can help in rooms with many people talking at once. Takes effect in the next level.");
             registerSetting(cat, settings.communication.deafenNotification, "Deafen notification", "Shows a notification when you deafen & undeafen.");
             registerSetting(cat, settings.communication.audioDevice, "Audio device", "The input device used for recording your voice.", Type::AudioDevice);
             // MAKE_SETTING(communication, voiceLoopback, "Voice loopback", "When enabled, you will hear your own voice as you speak.");
@@ -270,6 +273,7 @@ void GlobedSettingsLayer::createSettingsCells(int category) {
             registerSetting(cat, settings.overlay.opacity, "Opacity", "Opacity of the displayed overlay.");
             registerSetting(cat, settings.overlay.hideConditionally, "Hide conditionally", "Hide the ping overlay when not connected to a server or in a non-uploaded level, instead of showing a substitute message.");
             registerSetting(cat, settings.overlay.position, "Position", "Position of the overlay on the screen.", Type::Corner);
+            registerSetting(cat, settings.overlay.networkStats, "Network stats", "Show the bandwidth usage, packet loss and jitter under the ping. Useful when reporting connection issues.");
         } break;
 
         case TAG_TAB_PLAYERS: {
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "bench.hpp"
 #include "cocos.hpp"
 #include "collections.hpp"
 #include "crypto.hpp"
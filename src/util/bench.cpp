@@ -0,0 +1,691 @@
+#include "bench.hpp"
+
+#include <audio/jitter_buffer.hpp>
+#include <audio/manager.hpp>
+#include <audio/voice_activity.hpp>
+#include <crypto/box.hpp>
+#include <crypto/chacha_secret_box.hpp>
+#include <data/bytebuffer.hpp>
+#include <data/packets/server/game.hpp>
+#include <data/types/game.hpp>
+#include <net/game_socket.hpp>
+#include <util/crypto.hpp>
+#include <util/debug.hpp>
+#include <util/format.hpp>
+#include <util/misc.hpp>
+#include <util/rng.hpp>
+
+using namespace util::debug;
+
+namespace util::bench {
+    void runAll() {
+        encodePlayerData();
+        rawWriteBytes();
+        cryptoThroughput();
+        voiceLoopbackStress();
+        voiceJitterSimulation();
+        voiceMixing();
+        voiceActivityDetection();
+    }
+
+    static SpecificIconData randomIconData() {
+        auto& rng = rng::Random::get();
+
+        SpecificIconData data {};
+        data.position = cocos2d::CCPoint{rng.generate<float>(0.f, 30000.f), rng.generate<float>(0.f, 3000.f)};
+        data.rotation = rng.generate<float>(-360.f, 360.f);
+        data.iconType = PlayerIconType::Cube;
+        data.isVisible = true;
+        data.isGrounded = rng.genRatio(0.5f);
+
+        return data;
+    }
+
+    void encodePlayerData() {
+        constexpr size_t COUNT = 1000;
+
+        std::vector<PlayerData> players(COUNT);
+        for (auto& pd : players) {
+            pd.timestamp = 12.5f;
+            pd.player1 = randomIconData();
+            pd.player2 = randomIconData();
+            pd.currentPercentage = 0.5f;
+        }
+
+        size_t totalBytes = 0;
+
+        // how every packet used to be encoded: a new buffer each time, growing as we write
+        auto tookFresh = Benchmarker().run([&] {
+            for (const auto& pd : players) {
+                ByteBuffer buf;
+                buf.writeValue(pd);
+                totalBytes += buf.size();
+            }
+        });
+
+        // reusing one buffer, reserved upfront
+        auto tookReserved = Benchmarker().run([&] {
+            ByteBuffer buf;
+            for (const auto& pd : players) {
+                buf.clear();
+                buf.reserve(ByteBuffer::encodedSize(pd));
+                buf.writeValue(pd);
+                totalBytes += buf.size();
+            }
+        });
+
+        // everything into one buffer, like a level data packet would be
+        auto tookSingle = Benchmarker().run([&] {
+            ByteBuffer buf;
+            buf.reserve(ByteBuffer::encodedSize(players));
+            buf.writeValue(players);
+            totalBytes += buf.size();
+        });
+
+        log::debug(
+            "Encoding {} PlayerData ({} bytes total): fresh buffers {}, reused buffer {}, single vector {}",
+            COUNT, totalBytes / 3, util::format::duration(tookFresh), util::format::duration(tookReserved), util::format::duration(tookSingle)
+        );
+    }
+
+    // `ByteBuffer::rawWriteBytes` before the append fast path, kept here for comparison
+    static void rawWriteBytesOld(util::data::bytevector& data, size_t& position, const util::data::byte* bytes, size_t length) {
+        if (position + length > data.size()) {
+            data.insert(data.begin() + position, bytes, bytes + length);
+            data.reserve(position + length);
+        } else {
+            for (size_t i = 0; i < length; i++) {
+                data.data()[position + i] = bytes[i];
+            }
+        }
+
+        position += length;
+    }
+
+    void rawWriteBytes() {
+        constexpr size_t TOTAL = 1024 * 1024;
+
+        util::data::byte chunk[64];
+        for (size_t i = 0; i < sizeof(chunk); i++) {
+            chunk[i] = static_cast<util::data::byte>(i);
+        }
+
+        for (size_t size : {4, 16, 64}) {
+            size_t writes = TOTAL / size;
+
+            util::data::bytevector oldData;
+            size_t oldPos = 0;
+
+            auto tookOldAppend = Benchmarker().run([&] {
+                for (size_t i = 0; i < writes; i++) {
+                    rawWriteBytesOld(oldData, oldPos, chunk, size);
+                }
+            });
+
+            oldPos = 0;
+            auto tookOldOverwrite = Benchmarker().run([&] {
+                for (size_t i = 0; i < writes; i++) {
+                    rawWriteBytesOld(oldData, oldPos, chunk, size);
+                }
+            });
+
+            ByteBuffer buf;
+
+            auto tookNewAppend = Benchmarker().run([&] {
+                for (size_t i = 0; i < writes; i++) {
+                    buf.rawWriteBytes(chunk, size);
+                }
+            });
+
+            buf.setPosition(0);
+            auto tookNewOverwrite = Benchmarker().run([&] {
+                for (size_t i = 0; i < writes; i++) {
+                    buf.rawWriteBytes(chunk, size);
+                }
+            });
+
+            bool same = oldData == buf.data();
+
+            log::debug(
+                "rawWriteBytes {} KiB in {} byte chunks: append old {} new {}, overwrite old {} new {}{}",
+                TOTAL / 1024, size,
+                util::format::duration(tookOldAppend), util::format::duration(tookNewAppend),
+                util::format::duration(tookOldOverwrite), util::format::duration(tookNewOverwrite),
+                same ? "" : " (OUTPUT MISMATCH)"
+            );
+        }
+    }
+
+    // Encrypts `payload` in place `iterations` times and decrypts it again, returns the time taken and whether every round trip matched
+    template <typename Box>
+    static std::pair<time::micros, bool> cryptoRoundTrips(Box& box, const data::bytevector& payload, size_t iterations) {
+        data::bytevector buf(payload.size() + Box::PREFIX_LEN);
+        bool ok = true;
+
+        auto took = Benchmarker().run([&] {
+            for (size_t i = 0; i < iterations; i++) {
+                std::memcpy(buf.data(), payload.data(), payload.size());
+
+                size_t encrypted = box.encryptInPlace(buf.data(), payload.size());
+                auto plaintext = box.decryptInPlaceView(buf.data(), encrypted);
+
+                ok = ok && plaintext && std::equal(plaintext.unwrap().begin(), plaintext.unwrap().end(), payload.begin(), payload.end());
+            }
+        });
+
+        return {took, ok};
+    }
+
+    void cryptoThroughput() {
+        constexpr size_t SIZES[] = {64, 512, 4096};
+        constexpr size_t TOTAL_BYTES = 16 * 1024 * 1024;
+
+        CryptoBox box1, box2;
+        box1.setPeerKey(box2.getPublicKey());
+
+        ChaChaSecretBox secretBox(util::crypto::secureRandom(ChaChaSecretBox::KEY_LEN));
+
+        auto mbps = [](size_t bytes, time::micros took) {
+            return took.count() == 0 ? 0.0 : static_cast<double>(bytes) / took.count();
+        };
+
+        for (size_t size : SIZES) {
+            auto payload = util::crypto::secureRandom(size);
+            size_t iterations = TOTAL_BYTES / size;
+
+            auto [tookBox, okBox] = cryptoRoundTrips(box1, payload, iterations);
+            auto [tookSecret, okSecret] = cryptoRoundTrips(secretBox, payload, iterations);
+
+            log::debug(
+                "Crypto round trip, {} x {} bytes: CryptoBox {} ({:.1f} MB/s{}), ChaChaSecretBox {} ({:.1f} MB/s{})",
+                iterations, size,
+                util::format::duration(tookBox), mbps(TOTAL_BYTES, tookBox), okBox ? "" : ", MISMATCH",
+                util::format::duration(tookSecret), mbps(TOTAL_BYTES, tookSecret), okSecret ? "" : ", MISMATCH"
+            );
+        }
+    }
+
+#if defined(GLOBED_VOICE_SUPPORT) && defined(GLOBED_DEBUG)
+    struct VoiceStressResult {
+        size_t received, lost, reordered;
+        uint64_t bytes;
+        time::micros took, p50, p99, max;
+    };
+#endif
+
+    void voiceLoopbackStress() {
+        // the loopback socket pair is only compiled into debug builds
+#if defined(GLOBED_VOICE_SUPPORT) && defined(GLOBED_DEBUG)
+        auto runPass = [](size_t workers) -> Result<VoiceStressResult> {
+            constexpr size_t PACKETS = 10000;
+            constexpr size_t OPUS_FRAME_BYTES = 120;
+
+            GameSocket server, client;
+            GLOBED_UNWRAP(GameSocket::connectLoopbackPair(server, client));
+            client.setCryptoWorkers(workers);
+
+            // a full frame, like someone talking continuously would send
+            auto packet = std::make_shared<VoiceBroadcastPacket>();
+            for (size_t i = 0; i < EncodedAudioFrame::LIMIT_REGULAR; i++) {
+                EncodedOpusData opus;
+                opus.length = OPUS_FRAME_BYTES;
+                opus.ptr = new data::byte[OPUS_FRAME_BYTES];
+                util::crypto::secureRandom(opus.ptr, OPUS_FRAME_BYTES);
+
+                GLOBED_UNWRAP(packet->frame.pushOpusFrame(opus));
+            }
+
+            // the packet index is sent as the sender ID
+            std::vector<std::atomic<int64_t>> sentAt(PACKETS);
+            std::atomic<bool> senderDone = false;
+            std::optional<std::string> sendError;
+            auto base = time::now();
+
+            std::thread sender([&] {
+                for (size_t i = 0; i < PACKETS; i++) {
+                    packet->sender = static_cast<int>(i);
+                    sentAt[i].store(time::as<time::micros>(time::now() - base).count(), std::memory_order::relaxed);
+
+                    auto result = server.sendPacket(packet);
+                    if (!result) {
+                        sendError = std::move(result.unwrapErr());
+                        break;
+                    }
+
+                    // loopback drops packets once the receive buffer is full, let the receiver catch up every now and then
+                    if (i % 64 == 63) {
+                        std::this_thread::yield();
+                    }
+                }
+
+                senderDone = true;
+            });
+
+            std::vector<time::micros> latencies;
+            latencies.reserve(PACKETS);
+            size_t reordered = 0;
+            int lastIndex = -1;
+            std::optional<std::string> recvError;
+
+            auto start = time::now();
+
+            while (latencies.size() < PACKETS && !recvError) {
+                auto pollResult = client.poll(200);
+                if (!pollResult) {
+                    recvError = std::move(pollResult.unwrapErr());
+                    break;
+                }
+
+                // once the sender is done, a quiet socket means the rest got dropped
+                if (pollResult.unwrap() == GameSocket::PollResult::None) {
+                    if (senderDone) break;
+                    continue;
+                }
+
+                do {
+                    auto received = client.recvPacketUDP();
+                    if (!received) {
+                        recvError = std::move(received.unwrapErr());
+                        break;
+                    }
+
+                    auto voice = std::static_pointer_cast<VoiceBroadcastPacket>(received.unwrap().packet);
+                    auto arrivedAt = time::as<time::micros>(time::now() - base).count();
+
+                    if (voice->sender < 0 || static_cast<size_t>(voice->sender) >= PACKETS) continue;
+
+                    latencies.push_back(time::micros(arrivedAt - sentAt[voice->sender].load(std::memory_order::relaxed)));
+
+                    if (voice->sender < lastIndex) reordered++;
+                    lastIndex = voice->sender;
+                } while (client.hasPendingUDP());
+            }
+
+            auto took = time::as<time::micros>(time::now() - start);
+            sender.join();
+
+            if (sendError) return Err(std::move(*sendError));
+            if (recvError) return Err(std::move(*recvError));
+            if (latencies.empty()) return Err("no packets were received");
+
+            std::sort(latencies.begin(), latencies.end());
+
+            return Ok(VoiceStressResult {
+                .received = latencies.size(),
+                .lost = PACKETS - latencies.size(),
+                .reordered = reordered,
+                .bytes = client.getStats().snapshot().bytesIn,
+                .took = took,
+                .p50 = latencies[latencies.size() / 2],
+                .p99 = latencies[latencies.size() * 99 / 100],
+                .max = latencies.back(),
+            });
+        };
+
+        for (size_t workers : {0, 2}) {
+            auto result = runPass(workers);
+            if (!result) {
+                log::debug("Voice loopback stress, {} crypto workers: failed: {}", workers, result.unwrapErr());
+                continue;
+            }
+
+            const auto& r = result.unwrap();
+            double seconds = std::max<double>(r.took.count(), 1.0) / 1'000'000.0;
+
+            log::debug(
+                "Voice loopback stress, {} crypto workers: {} packets in {} ({:.0f} packets/s, {:.1f} MB/s), {} lost, {} reordered. Latency p50 {}, p99 {}, max {}",
+                workers, r.received, util::format::duration(r.took), r.received / seconds, r.bytes / seconds / 1'000'000.0,
+                r.lost, r.reordered, util::format::duration(r.p50), util::format::duration(r.p99), util::format::duration(r.max)
+            );
+        }
+#elif defined(GLOBED_VOICE_SUPPORT)
+        log::debug("Voice loopback stress: skipped, only available in debug builds");
+#else
+        log::debug("Voice loopback stress: skipped, voice is not supported on this platform");
+#endif
+    }
+
+#ifdef GLOBED_VOICE_SUPPORT
+    struct JitterScenario {
+        time::micros jitter; // extra network delay, uniformly distributed between 0 and this
+        float loss;
+        size_t framesPerPacket;
+    };
+
+    struct JitterSimResult {
+        double underrunRatio; // mixer reads during speech that came up short
+        time::micros addedAvg, addedP95; // from when a frame could have been played at the earliest until it is heard
+        VoiceJitterBuffer::Stats stats;
+        time::micros target;
+    };
+
+    // If `useBuffer` is false, frames are played as soon as they arrive, like before there was a jitter buffer
+    static JitterSimResult simulateVoiceJitter(const JitterScenario& scenario, bool useBuffer) {
+        constexpr int64_t FRAME_US = VOICE_TARGET_FRAMESIZE * 1'000'000 / VOICE_TARGET_SAMPLERATE;
+        constexpr int64_t FRAME_SAMPLES = VOICE_TARGET_FRAMESIZE;
+        constexpr int64_t STEP_US = 5'000; // how often the decode thread runs
+        constexpr int64_t MIXER_US = FRAME_US / 2; // how often FMOD reads, with `decodebuffersize` set to half a frame
+        constexpr int64_t MIXER_SAMPLES = FRAME_SAMPLES / 2;
+        constexpr int64_t BASE_DELAY_US = 40'000;
+        constexpr size_t SPURTS = 10;
+        constexpr size_t SPURT_FRAMES = 100;
+        constexpr int64_t PAUSE_US = 2'000'000;
+
+        auto& rng = rng::Random::get();
+
+        struct SimPacket {
+            int64_t arrival;
+            uint16_t sequence;
+            std::shared_ptr<const EncodedAudioFrame> frame;
+        };
+
+        std::vector<SimPacket> packets;
+        std::vector<size_t> spurtOf;
+
+        int64_t spurtStart = 0;
+        uint16_t sequence = 0;
+        for (size_t spurt = 0; spurt < SPURTS; spurt++) {
+            for (size_t i = 0; i < SPURT_FRAMES; i += scenario.framesPerPacket) {
+                size_t count = std::min(scenario.framesPerPacket, SPURT_FRAMES - i);
+
+                auto frame = std::make_shared<EncodedAudioFrame>();
+                for (size_t j = 0; j < count; j++) {
+                    EncodedOpusData opus;
+                    opus.length = 1;
+                    opus.ptr = new data::byte[1]{};
+                    (void) frame->pushOpusFrame(opus);
+
+                    spurtOf.push_back(spurt);
+                }
+
+                // a packet goes out once its last frame is recorded
+                int64_t sentAt = spurtStart + static_cast<int64_t>(i + count) * FRAME_US;
+                int64_t jitter = static_cast<int64_t>(rng.generate<float>(0.f, static_cast<float>(scenario.jitter.count())));
+
+                if (!rng.genRatio(scenario.loss)) {
+                    packets.push_back(SimPacket {
+                        .arrival = sentAt + BASE_DELAY_US + jitter,
+                        .sequence = sequence,
+                        .frame = std::move(frame),
+                    });
+                }
+
+                sequence += count;
+            }
+
+            spurtStart += SPURT_FRAMES * FRAME_US + PAUSE_US;
+        }
+
+        std::sort(packets.begin(), packets.end(), [](const auto& a, const auto& b) {
+            return a.arrival < b.arrival;
+        });
+
+        auto toTimePoint = [](int64_t us) {
+            return time::time_point{} + time::micros(us);
+        };
+
+        VoiceJitterBuffer buffer{time::micros(FRAME_US)};
+        std::vector<int64_t> readyAt(spurtOf.size());
+        std::vector<int64_t> added;
+
+        int64_t queued = 0; // samples waiting for the mixer
+        int64_t speechUntil = 0;
+        size_t currentSpurt = SIZE_MAX;
+        size_t speechReads = 0, shortReads = 0;
+        size_t nextPacket = 0;
+
+        int64_t now = 0;
+
+        auto play = [&](uint16_t seq, bool real) {
+            int64_t heardAt = now + queued * 1'000'000 / VOICE_TARGET_SAMPLERATE;
+            queued += FRAME_SAMPLES;
+
+            if (real) {
+                added.push_back(heardAt - readyAt[seq]);
+            }
+
+            // from the first real frame of a spurt that is heard, the rest of the spurt should play without gaps.
+            // concealment at the end of a spurt carries the sequence number of the next one, so it doesn't count
+            if (real && spurtOf[seq] != currentSpurt) {
+                currentSpurt = spurtOf[seq];
+                size_t remaining = SPURT_FRAMES - seq % SPURT_FRAMES;
+                speechUntil = heardAt + static_cast<int64_t>(remaining) * FRAME_US;
+            }
+        };
+
+        for (; now < spurtStart; now += STEP_US) {
+            while (nextPacket < packets.size() && packets[nextPacket].arrival <= now) {
+                auto& packet = packets[nextPacket++];
+
+                for (size_t i = 0; i < packet.frame->size(); i++) {
+                    readyAt[packet.sequence + i] = packet.arrival + static_cast<int64_t>(i) * FRAME_US;
+                }
+
+                if (useBuffer) {
+                    buffer.push(packet.sequence, packet.frame, toTimePoint(packet.arrival));
+                } else {
+                    for (size_t i = 0; i < packet.frame->size(); i++) {
+                        play(packet.sequence + i, true);
+                    }
+                }
+            }
+
+            while (useBuffer && queued < FRAME_SAMPLES) {
+                auto output = buffer.pop(toTimePoint(now));
+                if (!output) break;
+
+                play(output->sequence, output->kind == VoiceJitterBuffer::Output::Kind::Play);
+            }
+
+            if (now % MIXER_US == 0) {
+                if (now < speechUntil) {
+                    speechReads++;
+                    if (queued < MIXER_SAMPLES) shortReads++;
+                }
+
+                queued = std::max<int64_t>(0, queued - MIXER_SAMPLES);
+            }
+        }
+
+        std::sort(added.begin(), added.end());
+
+        int64_t addedSum = 0;
+        for (auto a : added) addedSum += a;
+
+        return JitterSimResult {
+            .underrunRatio = speechReads ? static_cast<double>(shortReads) / speechReads : 0.0,
+            .addedAvg = time::micros(added.empty() ? 0 : addedSum / static_cast<int64_t>(added.size())),
+            .addedP95 = time::micros(added.empty() ? 0 : added[added.size() * 95 / 100]),
+            .stats = buffer.stats(),
+            .target = buffer.targetDelay(),
+        };
+    }
+#endif
+
+    void voiceJitterSimulation() {
+#ifdef GLOBED_VOICE_SUPPORT
+        const JitterScenario scenarios[] = {
+            {time::millis(0), 0.f, EncodedAudioFrame::LIMIT_REGULAR},
+            {time::millis(30), 0.f, EncodedAudioFrame::LIMIT_REGULAR},
+            {time::millis(30), 0.05f, EncodedAudioFrame::LIMIT_REGULAR},
+            {time::millis(100), 0.05f, EncodedAudioFrame::LIMIT_REGULAR},
+            {time::millis(200), 0.1f, EncodedAudioFrame::LIMIT_REGULAR},
+            {time::millis(30), 0.05f, EncodedAudioFrame::LIMIT_LOW_LATENCY},
+        };
+
+        for (const auto& scenario : scenarios) {
+            auto buffered = simulateVoiceJitter(scenario, true);
+            auto direct = simulateVoiceJitter(scenario, false);
+
+            log::debug(
+                "Voice jitter simulation, 0-{} jitter, {:.0f}% loss, {} frames per packet: underruns {:.1f}% (without buffer {:.1f}%), "
+                "added latency avg {} p95 {} (without buffer avg {} p95 {}), final target {}. "
+                "Concealed {} ({} with FEC), lost {}, late {}, stalls {}, shrunk {}",
+                util::format::duration(scenario.jitter), scenario.loss * 100.f, scenario.framesPerPacket,
+                buffered.underrunRatio * 100.0, direct.underrunRatio * 100.0,
+                util::format::duration(buffered.addedAvg), util::format::duration(buffered.addedP95),
+                util::format::duration(direct.addedAvg), util::format::duration(direct.addedP95),
+                util::format::duration(buffered.target),
+                buffered.stats.concealed, buffered.stats.concealedFec, buffered.stats.lost, buffered.stats.late,
+                buffered.stats.stalls, buffered.stats.shrunk
+            );
+        }
+#else
+        log::debug("Voice jitter simulation: skipped, voice is not supported on this platform");
+#endif
+    }
+
+    void voiceMixing() {
+        constexpr size_t SPEAKERS[] = {1, 8, 32};
+        constexpr size_t SAMPLES = 720; // half an opus frame, what FMOD reads at once
+        constexpr size_t ITERATIONS = 20000;
+
+        auto& rng = rng::Random::get();
+
+        for (size_t speakers : SPEAKERS) {
+            std::vector<std::vector<float>> sources(speakers, std::vector<float>(SAMPLES));
+            std::vector<float> gains(speakers);
+
+            for (size_t i = 0; i < speakers; i++) {
+                for (auto& sample : sources[i]) {
+                    sample = rng.generate<float>(-1.f, 1.f);
+                }
+
+                gains[i] = rng.generate<float>(0.f, 2.f);
+            }
+
+            std::vector<float> outSimd(SAMPLES), outScalar(SAMPLES);
+
+            auto mixAll = [&](std::vector<float>& out, auto&& mixOne) {
+                std::fill(out.begin(), out.end(), 0.f);
+
+                for (size_t i = 0; i < speakers; i++) {
+                    mixOne(out.data(), sources[i].data(), SAMPLES, gains[i]);
+                }
+            };
+
+            auto tookSimd = Benchmarker().run([&] {
+                for (size_t i = 0; i < ITERATIONS; i++) {
+                    mixAll(outSimd, util::misc::mixPcm);
+                }
+            });
+
+            auto tookScalar = Benchmarker().run([&] {
+                for (size_t i = 0; i < ITERATIONS; i++) {
+                    mixAll(outScalar, util::misc::mixPcmSlow);
+                }
+            });
+
+            bool ok = true;
+            for (size_t i = 0; i < SAMPLES; i++) {
+                // the order of operations is the same, but the scalar loop may get fused multiply-adds
+                ok = ok && std::abs(outSimd[i] - outScalar[i]) < 1e-4f;
+            }
+
+            log::debug(
+                "Voice mixing, {} speakers x {} samples, {} iterations: simd {} ({} per read), scalar {} ({} per read){}",
+                speakers, SAMPLES, ITERATIONS,
+                util::format::duration(tookSimd), util::format::duration(time::as<time::nanos>(tookSimd) / ITERATIONS),
+                util::format::duration(tookScalar), util::format::duration(time::as<time::nanos>(tookScalar) / ITERATIONS),
+                ok ? "" : ", MISMATCH"
+            );
+        }
+    }
+
+#ifdef GLOBED_VOICE_SUPPORT
+    struct VadSegment {
+        const char* name;
+        float seconds;
+        float noise;    // amplitude of white background noise
+        float voiced;   // amplitude of a 140 Hz voice with a few harmonics, pulsing like syllables
+        float unvoiced; // amplitude of extra white noise, like an "s"
+    };
+#endif
+
+    void voiceActivityDetection() {
+#ifdef GLOBED_VOICE_SUPPORT
+        constexpr size_t ITERATIONS = 100000;
+        constexpr float PI = 3.14159265f;
+
+        auto& rng = rng::Random::get();
+
+        std::vector<float> frame(VOICE_TARGET_FRAMESIZE);
+        for (auto& sample : frame) {
+            sample = rng.generate<float>(-0.5f, 0.5f);
+        }
+
+        util::simd::PcmActivity simdResult{}, scalarResult{};
+
+        auto tookSimd = Benchmarker().run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                simdResult = util::misc::calculatePcmActivity(frame.data(), frame.size());
+            }
+        });
+
+        auto tookScalar = Benchmarker().run([&] {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                scalarResult = util::misc::pcmActivitySlow(frame.data(), frame.size());
+            }
+        });
+
+        bool ok = std::abs(simdResult.energy - scalarResult.energy) < 1e-4f && simdResult.zeroCrossingRate == scalarResult.zeroCrossingRate;
+
+        log::debug(
+            "Voice activity, {} iterations: simd {} ({} per frame), scalar {} ({} per frame){}",
+            ITERATIONS,
+            util::format::duration(tookSimd), util::format::duration(time::as<time::nanos>(tookSimd) / ITERATIONS),
+            util::format::duration(tookScalar), util::format::duration(time::as<time::nanos>(tookScalar) / ITERATIONS),
+            ok ? "" : ", MISMATCH"
+        );
+
+        const VadSegment segments[] = {
+            {"room noise", 3.f, 0.003f, 0.f, 0.f},
+            {"talking", 2.f, 0.003f, 0.1f, 0.f},
+            {"room noise", 1.f, 0.003f, 0.f, 0.f},
+            {"quiet \"s\"", 0.3f, 0.003f, 0.f, 0.0045f},
+            {"room noise", 2.f, 0.003f, 0.f, 0.f},
+            {"fan", 4.f, 0.03f, 0.f, 0.f},
+            {"talking over fan", 2.f, 0.03f, 0.2f, 0.f},
+            {"fan", 2.f, 0.03f, 0.f, 0.f},
+        };
+
+        const size_t hangover = static_cast<size_t>(std::round(0.4f / VOICE_CHUNK_RECORD_TIME));
+
+        VoiceActivityDetector vad;
+        vad.setHangover(hangover);
+
+        size_t sampleIdx = 0;
+
+        for (const auto& segment : segments) {
+            size_t frames = static_cast<size_t>(segment.seconds / VOICE_CHUNK_RECORD_TIME);
+            size_t sent = 0;
+
+            for (size_t f = 0; f < frames; f++) {
+                for (auto& sample : frame) {
+                    float t = static_cast<float>(sampleIdx++) / VOICE_TARGET_SAMPLERATE;
+
+                    float voice = 0.f;
+                    for (int harmonic = 1; harmonic <= 4; harmonic++) {
+                        voice += std::sin(2.f * PI * 140.f * harmonic * t) / harmonic;
+                    }
+
+                    // 4 syllables per second
+                    float envelope = 0.5f + 0.5f * std::sin(2.f * PI * 4.f * t);
+
+                    sample = rng.generate<float>(-segment.noise, segment.noise)
+                        + segment.voiced * envelope * voice
+                        + (segment.unvoiced > 0.f ? rng.generate<float>(-segment.unvoiced, segment.unvoiced) : 0.f);
+                }
+
+                if (vad.process(frame.data(), frame.size())) {
+                    sent++;
+                }
+            }
+
+            log::debug("Voice activity, {} for {}s: sent {} out of {} frames (hangover {} frames)", segment.name, segment.seconds, sent, frames, hangover);
+        }
+#else
+        log::debug("Voice activity: skipped, voice is not supported on this platform");
+#endif
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+* Microbenchmarks for hot paths, ran from the advanced settings menu. Results are printed with log::debug.
+*/
+
+namespace util::bench {
+    // Runs everything below
+    void runAll();
+
+    // Encode 1000 `PlayerData` structs into fresh buffers, and into a single buffer reserved with `ByteBuffer::encodedSize`
+    void encodePlayerData();
+
+    // Writes 4, 16 and 64 byte chunks with `ByteBuffer::rawWriteBytes`, appending and overwriting,
+    // next to the old implementation that overwrote existing bytes in a per-byte loop
+    void rawWriteBytes();
+
+    // Encrypts and decrypts 64 B, 512 B and 4 KiB payloads in place with `CryptoBox` and `ChaChaSecretBox`,
+    // checks that every payload survives the round trip and reports the throughput
+    void cryptoThroughput();
+
+    // Sends 10000 encrypted `VoiceBroadcastPacket`s between two `GameSocket`s over loopback UDP, once with crypto workers and once without,
+    // and reports the throughput, the latency percentiles and how many packets were lost or reordered. Only runs in debug builds.
+    void voiceLoopbackStress();
+
+    // Simulates a few talk spurts going through `VoiceJitterBuffer` with different amounts of network jitter and packet loss,
+    // and reports how often playback ran dry mid-speech and how much latency the buffer added, compared to playing frames as soon as they arrive
+    void voiceJitterSimulation();
+
+    // Mixes 1, 8 and 32 speakers into one buffer, the way `VoiceMixer` does in a single FMOD read,
+    // with `util::simd::mixPcm` and with the scalar loop, and checks that both give the same output
+    void voiceMixing();
+
+    // Computes the energy and zero-crossing rate of a recorded frame with `util::simd::calcPcmActivity` and with the scalar loop,
+    // then runs a synthetic recording (room noise, talking, a quiet "s", a fan turning on) through `VoiceActivityDetector`
+    // and reports how much of each part would be sent
+    void voiceActivityDetection();
+}
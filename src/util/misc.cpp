@@ -50,6 +50,42 @@ namespace util::misc {
         return static_cast<float>(sum / static_cast<double>(samples));
     }
 
+    simd::PcmActivity calculatePcmActivity(const float* pcm, size_t samples) {
+        return simd::calcPcmActivity(pcm, samples);
+    }
+
+    simd::PcmActivity pcmActivitySlow(const float* pcm, size_t samples) {
+        if (samples == 0) {
+            return {};
+        }
+
+        double energy = 0.0;
+        size_t crossings = 0;
+
+        for (size_t i = 0; i < samples; i++) {
+            energy += static_cast<double>(pcm[i]) * static_cast<double>(pcm[i]);
+
+            if (i > 0 && std::signbit(pcm[i]) != std::signbit(pcm[i - 1])) {
+                crossings++;
+            }
+        }
+
+        return {
+            .energy = static_cast<float>(energy / static_cast<double>(samples)),
+            .zeroCrossingRate = samples < 2 ? 0.f : static_cast<float>(crossings) / static_cast<float>(samples - 1),
+        };
+    }
+
+    void mixPcm(float* dest, const float* src, size_t samples, float gain) {
+        simd::mixPcm(dest, src, samples, gain);
+    }
+
+    void mixPcmSlow(float* dest, const float* src, size_t samples, float gain) {
+        for (size_t i = 0; i < samples; i++) {
+            dest[i] += src[i] * gain;
+        }
+    }
+
     bool compareName(const std::string_view nv1, const std::string_view nv2) {
         std::string name1(nv1);
         std::string name2(nv2);
@@ -2,6 +2,7 @@
 #include <defs/essential.hpp>
 #include <defs/geode.hpp>
 #include <data/types/basic/either.hpp>
+#include <util/simd.hpp>
 
 #include <functional>
 #include <string_view>
@@ -79,6 +80,16 @@ namespace util::misc {
 
     float pcmVolumeSlow(const float* pcm, size_t samples);
 
+    // Calculate the energy and the zero-crossing rate of pcm samples, used for voice activity detection
+    simd::PcmActivity calculatePcmActivity(const float* pcm, size_t samples);
+
+    simd::PcmActivity pcmActivitySlow(const float* pcm, size_t samples);
+
+    // Add `src * gain` to `dest`, used for mixing multiple audio sources together
+    void mixPcm(float* dest, const float* src, size_t samples, float gain);
+
+    void mixPcmSlow(float* dest, const float* src, size_t samples, float gain);
+
     bool compareName(const std::string_view name1, const std::string_view name2);
 
     bool isEditorCollabLevel(LevelId levelId);
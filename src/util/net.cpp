@@ -79,27 +79,97 @@ namespace util::net {
         return Ok(out);
     }
 
-    bool sameSockaddr(const sockaddr_in& s1, const sockaddr_in& s2) {
-        if (s1.sin_family != s2.sin_family || s1.sin_port != s2.sin_port) {
+    // Returns the IPv4 address if `addr` is IPv4 or IPv4-mapped IPv6, otherwise nullptr
+    static const in_addr* asIPv4(const sockaddr_storage& addr) {
+        if (addr.ss_family == AF_INET) {
+            return &reinterpret_cast<const sockaddr_in&>(addr).sin_addr;
+        }
+
+        if (addr.ss_family == AF_INET6) {
+            auto& addr6 = reinterpret_cast<const sockaddr_in6&>(addr).sin6_addr;
+            if (IN6_IS_ADDR_V4MAPPED(&addr6)) {
+                return reinterpret_cast<const in_addr*>(reinterpret_cast<const uint8_t*>(&addr6) + 12);
+            }
+        }
+
+        return nullptr;
+    }
+
+    static uint16_t sockaddrPort(const sockaddr_storage& addr) {
+        return addr.ss_family == AF_INET6
+            ? reinterpret_cast<const sockaddr_in6&>(addr).sin6_port
+            : reinterpret_cast<const sockaddr_in&>(addr).sin_port;
+    }
+
+    bool sameSockaddr(const sockaddr_storage& s1, const sockaddr_storage& s2) {
+        if (sockaddrPort(s1) != sockaddrPort(s2)) {
+            return false;
+        }
+
+        // a dual-stack socket reports IPv4 peers as IPv4-mapped IPv6 addresses
+        auto* v4a = asIPv4(s1);
+        auto* v4b = asIPv4(s2);
+
+        if (v4a || v4b) {
+            return v4a && v4b && std::memcmp(v4a, v4b, sizeof(in_addr)) == 0;
+        }
+
+        if (s1.ss_family != AF_INET6 || s2.ss_family != AF_INET6) {
             return false;
         }
 
-        return std::memcmp(&s1.sin_addr, &s2.sin_addr, sizeof(s1.sin_addr)) == 0;
+        auto& a = reinterpret_cast<const sockaddr_in6&>(s1);
+        auto& b = reinterpret_cast<const sockaddr_in6&>(s2);
+
+        return std::memcmp(&a.sin6_addr, &b.sin6_addr, sizeof(a.sin6_addr)) == 0;
+    }
+
+    int sockaddrLength(const sockaddr_storage& addr) {
+        return addr.ss_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    }
+
+    void mapToIPv6(sockaddr_storage& addr) {
+        if (addr.ss_family != AF_INET) return;
+
+        auto v4 = reinterpret_cast<const sockaddr_in&>(addr);
+
+        sockaddr_in6 v6 = {};
+        v6.sin6_family = AF_INET6;
+        v6.sin6_port = v4.sin_port;
+
+        // ::ffff:a.b.c.d
+        auto* bytes = reinterpret_cast<uint8_t*>(&v6.sin6_addr);
+        bytes[10] = 0xff;
+        bytes[11] = 0xff;
+        std::memcpy(bytes + 12, &v4.sin_addr, sizeof(in_addr));
+
+        std::memset(&addr, 0, sizeof(addr));
+        std::memcpy(&addr, &v6, sizeof(v6));
+    }
+
+    void setSockaddrPort(sockaddr_storage& addr, uint16_t port) {
+        if (addr.ss_family == AF_INET6) {
+            reinterpret_cast<sockaddr_in6&>(addr).sin6_port = hostToNetworkPort(port);
+        } else {
+            reinterpret_cast<sockaddr_in&>(addr).sin_port = hostToNetworkPort(port);
+        }
     }
 
     Result<std::string> getaddrinfo(const std::string_view hostname) {
-        auto ipaddr = std::make_unique<sockaddr_in>();
+        std::vector<sockaddr_storage> addresses;
 
-        GLOBED_UNWRAP(getaddrinfo(hostname, *ipaddr));
+        GLOBED_UNWRAP(getaddrinfo(hostname, addresses));
 
-        return inAddrToString(ipaddr->sin_addr);
+        return sockaddrToString(addresses.front());
     }
 
-    Result<> getaddrinfo(const std::string_view hostname, sockaddr_in& out) {
+    Result<> getaddrinfo(const std::string_view hostname, std::vector<sockaddr_storage>& out) {
         struct addrinfo hints = {};
-        hints.ai_family = AF_INET;
+        hints.ai_family = AF_UNSPEC;
         hints.ai_socktype = SOCK_DGRAM;
         hints.ai_protocol = IPPROTO_UDP;
+        // skip address families this machine has no route for
+        hints.ai_flags = AI_ADDRCONFIG;
 
         struct addrinfo* result;
 
@@ -107,43 +177,58 @@ namespace util::net {
             return Err(util::net::lastErrorString());
         }
 
-        if (result->ai_family != AF_INET || result->ai_socktype != SOCK_DGRAM || result->ai_protocol != IPPROTO_UDP) {
-            ::freeaddrinfo(result);
-            return Err("getaddrinfo returned wrong output");
-        }
+        out.clear();
 
-        auto* ipaddr = (struct sockaddr_in*) result->ai_addr;
+        // keep the order, getaddrinfo already sorts by preference (RFC 6724)
+        for (auto* ai = result; ai != nullptr; ai = ai->ai_next) {
+            if (ai->ai_family != AF_INET && ai->ai_family != AF_INET6) continue;
+            if (ai->ai_addrlen > sizeof(sockaddr_storage)) continue;
 
-        std::memcpy(&out, ipaddr, sizeof(sockaddr_in));
+            sockaddr_storage addr = {};
+            std::memcpy(&addr, ai->ai_addr, ai->ai_addrlen);
+            out.push_back(addr);
+        }
 
         ::freeaddrinfo(result);
 
+        GLOBED_REQUIRE_SAFE(!out.empty(), "getaddrinfo returned no IPv4 or IPv6 addresses");
+
         return Ok();
     }
 
-    Result<std::string> inAddrToString(const in_addr& addr) {
-        std::string out;
-        out.resize(16);
+    Result<std::string> sockaddrToString(const sockaddr_storage& addr) {
+        char buf[INET6_ADDRSTRLEN] = {};
 
-        auto ntopResult = inet_ntop(AF_INET, &addr, out.data(), 16);
+        const char* ntopResult;
+        if (addr.ss_family == AF_INET6) {
+            ntopResult = inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6&>(addr).sin6_addr, buf, sizeof(buf));
+        } else {
+            ntopResult = inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in&>(addr).sin_addr, buf, sizeof(buf));
+        }
 
         if (ntopResult == nullptr) {
             return Err(lastErrorString());
         }
 
-        out.resize(std::strlen(out.c_str()));
-
-        return Ok(std::move(out));
+        return Ok(std::string(buf));
     }
 
-    Result<> stringToInAddr(const char* addr, in_addr& out) {
-        auto ptonResult = inet_pton(AF_INET, addr, &out);
+    Result<> stringToSockaddr(const char* addr, sockaddr_storage& out) {
+        std::memset(&out, 0, sizeof(out));
 
-        if (ptonResult > 0) {
+        auto& v4 = reinterpret_cast<sockaddr_in&>(out);
+        if (inet_pton(AF_INET, addr, &v4.sin_addr) > 0) {
+            v4.sin_family = AF_INET;
             return Ok();
-        } else {
-            return Err(lastErrorString());
         }
+
+        auto& v6 = reinterpret_cast<sockaddr_in6&>(out);
+        if (inet_pton(AF_INET6, addr, &v6.sin6_addr) > 0) {
+            v6.sin6_family = AF_INET6;
+            return Ok();
+        }
+
+        return Err("not a valid IPv4 or IPv6 address");
     }
 
     uint16_t hostToNetworkPort(uint16_t port) {
@@ -2,9 +2,9 @@
 #include <defs/minimal_geode.hpp>
 #include <defs/net.hpp>
 #include <string>
+#include <vector>
 
-struct sockaddr_in;
-struct in_addr;
+struct sockaddr_storage;
 
 namespace util::net {
     // Initialize all networking libraries (calls `WSAStartup` on Windows, does nothing on other platforms)
@@ -34,15 +34,28 @@ namespace util::net {
     // Split an address like 127.0.0.1:4343 into pair("127.0.0.1", 4343)
     Result<std::pair<std::string, unsigned short>> splitAddress(const std::string_view address, unsigned short defaultPort = 0);
 
-    // Check if two sockaddr structures are equal
-    bool sameSockaddr(const sockaddr_in& s1, const sockaddr_in& s2);
+    // Check if two socket addresses are equal. An IPv4 address equals its IPv4-mapped IPv6 form.
+    bool sameSockaddr(const sockaddr_storage& s1, const sockaddr_storage& s2);
 
-    // getaddrinfo
+    // Returns the size of the actual sockaddr struct in `addr` (`sockaddr_in` or `sockaddr_in6`)
+    int sockaddrLength(const sockaddr_storage& addr);
+
+    // Converts an IPv4 address into its IPv4-mapped IPv6 form (::ffff:a.b.c.d), for use with dual-stack sockets.
+    // IPv6 addresses are left unchanged.
+    void mapToIPv6(sockaddr_storage& addr);
+
+    // Sets the port (in host byte order) of an IPv4 or IPv6 address
+    void setSockaddrPort(sockaddr_storage& addr, uint16_t port);
+
+    // getaddrinfo, returns all IPv4 and IPv6 addresses of `hostname`, most preferred first
     Result<std::string> getaddrinfo(const std::string_view hostname);
-    Result<> getaddrinfo(const std::string_view hostname, sockaddr_in& out);
+    Result<> getaddrinfo(const std::string_view hostname, std::vector<sockaddr_storage>& out);
+
+    // Formats the IP of an IPv4 or IPv6 address, without the port
+    Result<std::string> sockaddrToString(const sockaddr_storage& addr);
 
-    Result<std::string> inAddrToString(const in_addr& addr);
-    Result<> stringToInAddr(const char* addr, in_addr& out);
+    // Parses an IPv4 or IPv6 address, without the port
+    Result<> stringToSockaddr(const char* addr, sockaddr_storage& out);
 
     uint16_t hostToNetworkPort(uint16_t port);
 
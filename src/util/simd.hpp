@@ -3,7 +3,17 @@
 #include <stddef.h>
 
 namespace util::simd {
+    struct PcmActivity {
+        float energy;           // mean square of the samples
+        float zeroCrossingRate; // fraction of adjacent samples that have a different sign
+    };
+
     float calcPcmVolume(const float* pcm, size_t samples);
 
+    PcmActivity calcPcmActivity(const float* pcm, size_t samples);
+
+    // Add `src * gain` to `dest`
+    void mixPcm(float* dest, const float* src, size_t samples, float gain);
+
     uint32_t adler32(const uint8_t* data, size_t len);
 }
\ No newline at end of file